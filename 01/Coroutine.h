@@ -0,0 +1,369 @@
+#pragma once
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <stdexcept>
+#include <mutex>
+#include <condition_variable>
+#include <variant>
+#include <type_traits>
+
+// C++20 协程支持：惰性启动的 task<T>、组合器 when_all/when_any、以及同步等待 sync_wait
+// 与 ThreadPool::schedule() 配合使用：co_await pool.schedule() 之后协程就运行在线程池的工作线程上，
+// 等待子任务时挂起协程而不是阻塞线程，少量线程即可承载大量进行中的逻辑任务
+namespace coro {
+
+    template<typename T = void>
+    class task;
+
+    namespace detail {
+
+        // 协程结束时把控制权直接交给等待它的协程（对称转移，不会加深调用栈）
+        struct final_awaiter {
+            bool await_ready() const noexcept { return false; }
+
+            template<typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept {
+                if (auto next = h.promise().continuation)
+                    return next;
+                return std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        struct promise_base {
+            std::coroutine_handle<> continuation;  // 等待本协程结果的协程
+            std::exception_ptr error;
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }  // 惰性启动
+            final_awaiter final_suspend() const noexcept { return {}; }
+            void unhandled_exception() noexcept { error = std::current_exception(); }
+        };
+
+        template<typename T>
+        struct task_promise : promise_base {
+            std::optional<T> value;
+
+            task<T> get_return_object() noexcept;
+
+            template<typename U>
+                requires std::convertible_to<U&&, T>
+            void return_value(U&& v) { value.emplace(std::forward<U>(v)); }
+
+            T result() {
+                if (error)
+                    std::rethrow_exception(error);
+                return std::move(*value);
+            }
+        };
+
+        template<>
+        struct task_promise<void> : promise_base {
+            task<void> get_return_object() noexcept;
+
+            void return_void() const noexcept {}
+
+            void result() {
+                if (error)
+                    std::rethrow_exception(error);
+            }
+        };
+
+        // 立即启动、结束后自行销毁的协程，用于在组合器中驱动子任务
+        struct detached {
+            struct promise_type {
+                detached get_return_object() const noexcept { return {}; }
+                std::suspend_never initial_suspend() const noexcept { return {}; }
+                std::suspend_never final_suspend() const noexcept { return {}; }
+                void return_void() const noexcept {}
+                void unhandled_exception() const noexcept { std::terminate(); }
+            };
+        };
+
+        // when_all 的汇合计数器：初值为子任务数+1，多出的1由等待方在挂起时扣掉，
+        // 这样无论子任务是在等待方挂起之前还是之后完成，都恰好由最后到达者恢复等待方
+        class counter {
+        public:
+            explicit counter(size_t n) : count(n + 1) {}
+
+            void arrive() noexcept {
+                if (count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    waiter.resume();
+            }
+
+            bool await_ready() const noexcept { return false; }
+
+            bool await_suspend(std::coroutine_handle<> h) noexcept {
+                waiter = h;
+                return count.fetch_sub(1, std::memory_order_acq_rel) != 1;  // 已全部完成则不挂起
+            }
+
+            void await_resume() const noexcept {}
+
+        private:
+            std::atomic<size_t> count;
+            std::coroutine_handle<> waiter;
+        };
+
+    } // namespace detail
+
+    // 惰性协程任务：创建时不运行，被 co_await 时才开始执行，完成后恢复等待方
+    template<typename T>
+    class task {
+    public:
+        using promise_type = detail::task_promise<T>;
+        using value_type = T;
+
+        task() noexcept = default;
+        explicit task(std::coroutine_handle<promise_type> h) noexcept : handle(h) {}
+
+        task(task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+        task& operator=(task&& other) noexcept {
+            if (this != &other) {
+                if (handle)
+                    handle.destroy();
+                handle = std::exchange(other.handle, nullptr);
+            }
+            return *this;
+        }
+
+        task(const task&) = delete;
+        task& operator=(const task&) = delete;
+
+        ~task() {
+            if (handle)
+                handle.destroy();
+        }
+
+        bool valid() const noexcept { return static_cast<bool>(handle); }
+
+        auto operator co_await() const noexcept {
+            struct awaiter {
+                std::coroutine_handle<promise_type> handle;
+
+                bool await_ready() const noexcept { return !handle || handle.done(); }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+                    handle.promise().continuation = caller;
+                    return handle;  // 对称转移：直接开始执行子协程
+                }
+
+                T await_resume() { return handle.promise().result(); }
+            };
+            return awaiter{ handle };
+        }
+
+    private:
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    namespace detail {
+
+        template<typename T>
+        task<T> task_promise<T>::get_return_object() noexcept {
+            return task<T>(std::coroutine_handle<task_promise<T>>::from_promise(*this));
+        }
+
+        inline task<void> task_promise<void>::get_return_object() noexcept {
+            return task<void>(std::coroutine_handle<task_promise<void>>::from_promise(*this));
+        }
+
+        template<typename T>
+        detached run_into(task<T> t, std::optional<T>& slot, std::exception_ptr& error, counter& done) {
+            try {
+                slot.emplace(co_await std::move(t));
+            } catch (...) {
+                error = std::current_exception();
+            }
+            done.arrive();  // 必须是最后一步：arrive可能恢复等待方并销毁slot所在的帧
+        }
+
+        inline detached run_into(task<void> t, std::exception_ptr& error, counter& done) {
+            try {
+                co_await std::move(t);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            done.arrive();
+        }
+
+        // when_any 的共享状态：第一个完成的子任务写入结果并恢复等待方，其余的结果被丢弃。
+        // 由 shared_ptr 持有，因为等待方恢复后，落后的子任务仍在运行
+        template<typename T>
+        struct any_state {
+            std::atomic<bool> decided{false};
+            std::atomic<int> gate{2};  // 等待方挂起、胜出者完成，两件事的后到者负责恢复
+            size_t index = 0;
+            std::optional<T> value;
+            std::exception_ptr error;
+            std::coroutine_handle<> waiter;
+
+            void finish() noexcept {
+                if (gate.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    waiter.resume();
+            }
+
+            // 等待胜出者的awaiter（状态本身含原子成员不可复制，所以单独给一个轻量的awaiter）
+            auto wait() noexcept {
+                struct awaiter {
+                    any_state* state;
+
+                    bool await_ready() const noexcept { return false; }
+
+                    bool await_suspend(std::coroutine_handle<> h) noexcept {
+                        state->waiter = h;
+                        return state->gate.fetch_sub(1, std::memory_order_acq_rel) != 1;
+                    }
+
+                    void await_resume() const noexcept {}
+                };
+                return awaiter{ this };
+            }
+        };
+
+        template<typename T>
+        detached run_any(task<T> t, size_t index, std::shared_ptr<any_state<T>> state) {
+            std::optional<T> value;
+            std::exception_ptr error;
+            try {
+                value.emplace(co_await std::move(t));
+            } catch (...) {
+                error = std::current_exception();
+            }
+            if (!state->decided.exchange(true, std::memory_order_acq_rel)) {
+                state->index = index;
+                state->value = std::move(value);
+                state->error = error;
+                state->finish();
+            }
+        }
+
+        inline detached run_any(task<void> t, size_t index, std::shared_ptr<any_state<std::monostate>> state) {
+            std::exception_ptr error;
+            try {
+                co_await std::move(t);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            if (!state->decided.exchange(true, std::memory_order_acq_rel)) {
+                state->index = index;
+                state->value.emplace();
+                state->error = error;
+                state->finish();
+            }
+        }
+
+    } // namespace detail
+
+    // 等待全部子任务完成，按原顺序返回结果；任一子任务抛出异常时重新抛出（保留第一个被记录的）。
+    // 子任务依次启动，运行到第一个挂起点（如 co_await pool.schedule()）后即转入线程池并行执行
+    template<typename T>
+    task<std::vector<T>> when_all(std::vector<task<T>> tasks) {
+        std::vector<std::optional<T>> slots(tasks.size());
+        std::vector<std::exception_ptr> errors(tasks.size());
+        detail::counter done(tasks.size());
+        for (size_t i = 0; i < tasks.size(); ++i)
+            detail::run_into(std::move(tasks[i]), slots[i], errors[i], done);
+        co_await done;
+
+        for (auto& e : errors)
+            if (e)
+                std::rethrow_exception(e);
+
+        std::vector<T> results;
+        results.reserve(slots.size());
+        for (auto& s : slots)
+            results.push_back(std::move(*s));
+        co_return results;
+    }
+
+    inline task<void> when_all(std::vector<task<void>> tasks) {
+        std::vector<std::exception_ptr> errors(tasks.size());
+        detail::counter done(tasks.size());
+        for (size_t i = 0; i < tasks.size(); ++i)
+            detail::run_into(std::move(tasks[i]), errors[i], done);
+        co_await done;
+
+        for (auto& e : errors)
+            if (e)
+                std::rethrow_exception(e);
+    }
+
+    // 等待第一个完成的子任务，返回它的下标和结果（或重新抛出它的异常）。
+    // 其余子任务继续运行直至结束，结果被丢弃
+    template<typename T>
+    task<std::pair<size_t, T>> when_any(std::vector<task<T>> tasks) {
+        if (tasks.empty())
+            throw std::invalid_argument("when_any on empty task list");
+
+        auto state = std::make_shared<detail::any_state<T>>();
+        for (size_t i = 0; i < tasks.size(); ++i)
+            detail::run_any(std::move(tasks[i]), i, state);
+        co_await state->wait();
+
+        if (state->error)
+            std::rethrow_exception(state->error);
+        co_return std::pair<size_t, T>(state->index, std::move(*state->value));
+    }
+
+    inline task<size_t> when_any(std::vector<task<void>> tasks) {
+        if (tasks.empty())
+            throw std::invalid_argument("when_any on empty task list");
+
+        auto state = std::make_shared<detail::any_state<std::monostate>>();
+        for (size_t i = 0; i < tasks.size(); ++i)
+            detail::run_any(std::move(tasks[i]), i, state);
+        co_await state->wait();
+
+        if (state->error)
+            std::rethrow_exception(state->error);
+        co_return state->index;
+    }
+
+    // 在普通（非协程）代码中阻塞等待一个task完成，是协程世界与同步代码之间的桥梁。
+    // 不要在线程池的工作线程里调用，否则会重新引入阻塞
+    template<typename T>
+    T sync_wait(task<T> t) {
+        // 完成信号用互斥锁+条件变量，且在持锁时通知：
+        // 保证等待方返回（并销毁这些局部变量）时，完成方已不再访问它们
+        struct signal {
+            std::mutex mutex;
+            std::condition_variable cv;
+            bool ready = false;
+        } done;
+        std::optional<std::conditional_t<std::is_void_v<T>, std::monostate, T>> value;
+        std::exception_ptr error;
+
+        [](task<T> t, auto& value, std::exception_ptr& error, signal& done) -> detail::detached {
+            try {
+                if constexpr (std::is_void_v<T>) {
+                    co_await std::move(t);
+                    value.emplace();
+                } else {
+                    value.emplace(co_await std::move(t));
+                }
+            } catch (...) {
+                error = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(done.mutex);
+            done.ready = true;
+            done.cv.notify_one();
+        }(std::move(t), value, error, done);
+
+        {
+            std::unique_lock<std::mutex> lock(done.mutex);
+            done.cv.wait(lock, [&] { return done.ready; });
+        }
+        if (error)
+            std::rethrow_exception(error);
+        if constexpr (!std::is_void_v<T>)
+            return std::move(*value);
+    }
+
+} // namespace coro
@@ -0,0 +1,112 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+// 直方图的分位数快照
+struct LatencySummary {
+    uint64_t count = 0;
+    std::chrono::nanoseconds p50{0}, p90{0}, p99{0}, p999{0}, max{0};
+};
+
+// 对数-线性分桶的延迟直方图（HDR Histogram 的简化版）
+// 每个2的幂区间再等分为16个子桶，相对误差不超过1/16；
+// 记录只是一次 relaxed 原子加，可以在工作线程上随时记录、在任意线程读取
+class LatencyHistogram {
+public:
+    static constexpr unsigned sub_bits = 4;
+    static constexpr size_t sub_count = size_t(1) << sub_bits;
+    static constexpr size_t bucket_count = (64 - sub_bits + 1) * sub_count;
+
+    // 记录一个以纳秒为单位的值
+    void record(uint64_t ns) noexcept {
+        buckets[index_of(ns)].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(1, std::memory_order_relaxed);
+        uint64_t prev = largest.load(std::memory_order_relaxed);
+        while (ns > prev && !largest.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    void record(std::chrono::nanoseconds d) noexcept {
+        record(d.count() > 0 ? static_cast<uint64_t>(d.count()) : 0);
+    }
+
+    uint64_t count() const noexcept { return total.load(std::memory_order_relaxed); }
+    uint64_t max() const noexcept { return largest.load(std::memory_order_relaxed); }
+
+    // 百分位数（p取0~100），返回所在桶的上界；没有样本时返回0
+    uint64_t percentile(double p) const noexcept {
+        uint64_t n = count();
+        if (n == 0)
+            return 0;
+        uint64_t rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(n) + 0.5);
+        if (rank < 1)
+            rank = 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < bucket_count; ++i) {
+            seen += buckets[i].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                uint64_t upper = upper_bound_of(i);
+                return upper < max() ? upper : max();
+            }
+        }
+        return max();
+    }
+
+    LatencySummary summary() const noexcept {
+        LatencySummary s;
+        s.count = count();
+        s.p50 = std::chrono::nanoseconds(percentile(50));
+        s.p90 = std::chrono::nanoseconds(percentile(90));
+        s.p99 = std::chrono::nanoseconds(percentile(99));
+        s.p999 = std::chrono::nanoseconds(percentile(99.9));
+        s.max = std::chrono::nanoseconds(max());
+        return s;
+    }
+
+    // 把另一个直方图的样本累加进来（用于合并各工作线程各自记录的直方图）
+    void merge(const LatencyHistogram& other) noexcept {
+        for (size_t i = 0; i < bucket_count; ++i) {
+            uint64_t n = other.buckets[i].load(std::memory_order_relaxed);
+            if (n != 0)
+                buckets[i].fetch_add(n, std::memory_order_relaxed);
+        }
+        total.fetch_add(other.count(), std::memory_order_relaxed);
+        uint64_t m = other.max();
+        uint64_t prev = largest.load(std::memory_order_relaxed);
+        while (m > prev && !largest.compare_exchange_weak(prev, m, std::memory_order_relaxed)) {
+        }
+    }
+
+    void reset() noexcept {
+        for (auto& b : buckets)
+            b.store(0, std::memory_order_relaxed);
+        total.store(0, std::memory_order_relaxed);
+        largest.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static size_t index_of(uint64_t v) noexcept {
+        if (v < sub_count)
+            return static_cast<size_t>(v);
+        unsigned msb = static_cast<unsigned>(std::bit_width(v)) - 1;  // 最高位，>= sub_bits
+        unsigned shift = msb - sub_bits;
+        size_t group = msb - sub_bits + 1;
+        return group * sub_count + static_cast<size_t>((v >> shift) & (sub_count - 1));
+    }
+
+    static uint64_t upper_bound_of(size_t index) noexcept {
+        if (index < sub_count)
+            return index;
+        size_t group = index / sub_count;
+        uint64_t sub = index % sub_count;
+        unsigned shift = static_cast<unsigned>(group - 1);
+        return ((sub_count + sub + 1) << shift) - 1;
+    }
+
+    std::atomic<uint64_t> buckets[bucket_count] = {};
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> largest{0};
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <utility>
+
+// 有界多生产者多消费者环形队列（Dmitry Vyukov 的经典实现）
+// 每个槽位带一个序号：序号等于入队位置时可写，等于入队位置+1时可读。
+// 生产者/消费者各自只用一次CAS抢占位置，之后读写槽位不需要任何锁；
+// 容量在构造时固定（向上取整到2的幂），满了 try_push 返回false，不会再分配内存
+template<typename T>
+class MpmcQueue {
+public:
+    explicit MpmcQueue(size_t capacity) {
+        size_t n = 2;
+        while (n < capacity)
+            n <<= 1;
+        mask = n - 1;
+        cells = std::make_unique<Cell[]>(n);
+        for (size_t i = 0; i < n; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    // 成功时移走value；队列满时返回false，value保持不变
+    bool try_push(T& value) {
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.data = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // 槽位还没被上一轮的消费者取走：队列满
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);  // 被其他生产者抢先，重读位置
+            }
+        }
+    }
+
+    // 队列空时返回false
+    bool try_pop(T& value) {
+        size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = std::move(cell.data);
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);  // 留给下一轮的生产者
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // 槽位还没被写入：队列空
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t capacity() const noexcept { return mask + 1; }
+
+    // 近似元素个数，只用于统计和唤醒判断
+    size_t size_approx() const noexcept {
+        size_t tail = enqueue_pos.load(std::memory_order_acquire);
+        size_t head = dequeue_pos.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    // 生产者和消费者的游标各占一条缓存行，避免互相使对方的缓存失效
+    alignas(64) std::atomic<size_t> enqueue_pos{0};
+    alignas(64) std::atomic<size_t> dequeue_pos{0};
+    alignas(64) size_t mask = 0;
+    std::unique_ptr<Cell[]> cells;
+};
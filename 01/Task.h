@@ -0,0 +1,304 @@
+#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <type_traits>
+#include <functional>
+
+// 只可移动的任务类型（替代 std::function<void()>）
+// 小的可调用对象直接存放在对象内部的缓冲区中，不产生堆分配；
+// 超过缓冲区大小或移动构造可能抛异常的可调用对象才退化为堆分配
+class Task {
+public:
+    // 内联缓冲区大小：与操作表指针合起来正好一个缓存行（64字节）
+    static constexpr size_t inline_size = 56;
+
+    Task() noexcept = default;
+
+    template<typename F>
+        requires (!std::same_as<std::decay_t<F>, Task>) && std::invocable<std::decay_t<F>&>
+    Task(F&& f) {
+        using Fn = std::decay_t<F>;
+        if constexpr (fits_inline<Fn>()) {
+            ::new (static_cast<void*>(storage)) Fn(std::forward<F>(f));
+            ops = &inline_ops<Fn>;
+        } else {
+            ::new (static_cast<void*>(storage)) Fn*(new Fn(std::forward<F>(f)));
+            ops = &heap_ops<Fn>;
+        }
+    }
+
+    Task(Task&& other) noexcept : ops(other.ops) {
+        if (ops) {
+            ops->move(storage, other.storage);
+            other.ops = nullptr;
+        }
+    }
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other.ops) {
+                other.ops->move(storage, other.storage);
+                ops = other.ops;
+                other.ops = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() { reset(); }
+
+    // 执行任务
+    void operator()() { ops->invoke(storage); }
+
+    explicit operator bool() const noexcept { return ops != nullptr; }
+
+    // 可调用对象是否存放在内联缓冲区中
+    template<typename Fn>
+    static constexpr bool fits_inline() {
+        return sizeof(Fn) <= inline_size
+            && alignof(Fn) <= alignof(std::max_align_t)
+            && std::is_nothrow_move_constructible_v<Fn>;
+    }
+
+private:
+    // 类型擦除后的操作表，每种可调用类型一份静态实例
+    struct Ops {
+        void (*invoke)(void*);
+        void (*move)(void* dst, void* src) noexcept;  // 移动到dst并销毁src
+        void (*destroy)(void*) noexcept;
+    };
+
+    template<typename Fn>
+    static constexpr Ops inline_ops = {
+        [](void* p) { (*static_cast<Fn*>(p))(); },
+        [](void* dst, void* src) noexcept {
+            ::new (dst) Fn(std::move(*static_cast<Fn*>(src)));
+            static_cast<Fn*>(src)->~Fn();
+        },
+        [](void* p) noexcept { static_cast<Fn*>(p)->~Fn(); }
+    };
+
+    template<typename Fn>
+    static constexpr Ops heap_ops = {
+        [](void* p) { (**static_cast<Fn**>(p))(); },
+        [](void* dst, void* src) noexcept { ::new (dst) Fn*(*static_cast<Fn**>(src)); },
+        [](void* p) noexcept { delete *static_cast<Fn**>(p); }
+    };
+
+    void reset() noexcept {
+        if (ops) {
+            ops->destroy(storage);
+            ops = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char storage[inline_size];
+    const Ops* ops = nullptr;
+};
+
+// 环形缓冲区实现的双端队列
+// std::deque 在反复 push/pop 时会不断申请和释放内部块，
+// 这里容量只增不减，稳态下入队出队都不再分配内存
+template<typename T>
+class TaskQueue {
+public:
+    TaskQueue() = default;
+    TaskQueue(const TaskQueue&) = delete;
+    TaskQueue& operator=(const TaskQueue&) = delete;
+
+    ~TaskQueue() {
+        while (!empty())
+            pop_front();
+        std::allocator<T>().deallocate(buffer, capacity);
+    }
+
+    bool empty() const noexcept { return count == 0; }
+    size_t size() const noexcept { return count; }
+
+    void push_back(T&& value) {
+        if (count == capacity)
+            grow();
+        ::new (static_cast<void*>(buffer + ((head + count) & (capacity - 1)))) T(std::move(value));
+        ++count;
+    }
+
+    T& front() noexcept { return buffer[head]; }
+    T& back() noexcept { return buffer[(head + count - 1) & (capacity - 1)]; }
+
+    void pop_front() noexcept {
+        buffer[head].~T();
+        head = (head + 1) & (capacity - 1);
+        --count;
+    }
+
+    void pop_back() noexcept {
+        back().~T();
+        --count;
+    }
+
+private:
+    // 容量翻倍（始终为2的幂，下标用按位与取模）
+    void grow() {
+        size_t new_capacity = capacity ? capacity * 2 : 64;
+        T* new_buffer = std::allocator<T>().allocate(new_capacity);
+        for (size_t i = 0; i < count; ++i) {
+            T& src = buffer[(head + i) & (capacity - 1)];
+            ::new (static_cast<void*>(new_buffer + i)) T(std::move(src));
+            src.~T();
+        }
+        std::allocator<T>().deallocate(buffer, capacity);
+        buffer = new_buffer;
+        capacity = new_capacity;
+        head = 0;
+    }
+
+    T* buffer = nullptr;
+    size_t capacity = 0;
+    size_t head = 0;
+    size_t count = 0;
+};
+
+// 固定尺寸内存块池，用于 promise/future 的共享状态
+// 按64字节划分尺寸等级，每个线程有一份本地缓存，缓存满了或空了再和全局链表批量交换；
+// 块一旦从系统申请就不再归还，稳态下分配/释放都不会调用malloc
+class BlockPool {
+public:
+    static constexpr size_t granularity = 64;  // 尺寸等级的粒度
+    static constexpr size_t class_count = 8;   // 最大块为 8*64=512 字节，更大的直接走operator new
+
+    static void* allocate(size_t bytes) {
+        size_t c = size_class(bytes);
+        if (c >= class_count)
+            return ::operator new(bytes);
+
+        LocalCache& cache = local_cache();
+        if (!cache.head[c])
+            refill(cache, c);
+        FreeBlock* block = cache.head[c];
+        cache.head[c] = block->next;
+        --cache.count[c];
+        return block;
+    }
+
+    static void deallocate(void* p, size_t bytes) noexcept {
+        size_t c = size_class(bytes);
+        if (c >= class_count) {
+            ::operator delete(p);
+            return;
+        }
+
+        LocalCache& cache = local_cache();
+        FreeBlock* block = static_cast<FreeBlock*>(p);
+        block->next = cache.head[c];
+        cache.head[c] = block;
+        if (++cache.count[c] > 2 * batch)
+            release(cache, c, batch);  // 本地缓存过多，归还一批给全局链表
+    }
+
+private:
+    static constexpr size_t batch = 32;  // 本地缓存与全局链表之间每次交换的块数
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct Central {
+        std::mutex mutex;
+        FreeBlock* head[class_count] = {};
+    };
+
+    struct LocalCache {
+        FreeBlock* head[class_count] = {};
+        size_t count[class_count] = {};
+
+        // 线程退出时把缓存的块全部还给全局链表
+        ~LocalCache() {
+            for (size_t c = 0; c < class_count; ++c)
+                release(*this, c, count[c]);
+        }
+    };
+
+    static size_t size_class(size_t bytes) noexcept {
+        return (bytes + granularity - 1) / granularity - 1;
+    }
+
+    static Central& central() {
+        static Central instance;
+        return instance;
+    }
+
+    static LocalCache& local_cache() {
+        static thread_local LocalCache cache;
+        return cache;
+    }
+
+    // 从全局链表取一批块；全局也空时向系统申请一整片再切分
+    static void refill(LocalCache& cache, size_t c) {
+        Central& g = central();
+        {
+            std::lock_guard<std::mutex> lock(g.mutex);
+            for (size_t i = 0; i < batch && g.head[c]; ++i) {
+                FreeBlock* block = g.head[c];
+                g.head[c] = block->next;
+                block->next = cache.head[c];
+                cache.head[c] = block;
+                ++cache.count[c];
+            }
+        }
+        if (cache.head[c])
+            return;
+
+        const size_t block_size = (c + 1) * granularity;
+        char* chunk = static_cast<char*>(::operator new(block_size * batch));
+        for (size_t i = 0; i < batch; ++i) {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + i * block_size);
+            block->next = cache.head[c];
+            cache.head[c] = block;
+        }
+        cache.count[c] += batch;
+    }
+
+    static void release(LocalCache& cache, size_t c, size_t n) noexcept {
+        if (n == 0)
+            return;
+        Central& g = central();
+        std::lock_guard<std::mutex> lock(g.mutex);
+        for (size_t i = 0; i < n && cache.head[c]; ++i) {
+            FreeBlock* block = cache.head[c];
+            cache.head[c] = block->next;
+            block->next = g.head[c];
+            g.head[c] = block;
+            --cache.count[c];
+        }
+    }
+};
+
+// 基于 BlockPool 的标准分配器，传给 std::promise(std::allocator_arg, ...)
+// 后 future 的共享状态和结果存储都从池中分配
+template<typename T>
+struct PoolAllocator {
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(BlockPool::allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        BlockPool::deallocate(p, n * sizeof(T));
+    }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept { return true; }
+};
@@ -0,0 +1,309 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <initializer_list>
+#include <ostream>
+#include <stdexcept>
+#include <exception>
+#include "ThreadPool.h"
+
+// 数据流图（DAG）执行器：先声明节点和依赖关系，之后每帧调用一次 run。
+// 节点的所有前驱完成后它立即被投递到线程池；一个节点完成时，就绪的后继中留一个在当前线程接着执行，
+// 其余的投递出去，整个过程没有任何工作线程阻塞在 future 上。
+// 图建好之后可以反复运行，每次运行前只重置每个节点的剩余依赖计数，不重新分配。
+// 同一张图同一时刻只能有一次运行
+class task_graph {
+public:
+    using Clock = std::chrono::steady_clock;
+    using node = size_t;
+
+    // 一次运行中某个节点的执行记录；worker 是执行它的工作线程下标
+    struct node_trace {
+        const std::string* name;
+        size_t worker;
+        Clock::time_point start;
+        Clock::time_point end;
+    };
+
+    task_graph() = default;
+    task_graph(const task_graph&) = delete;
+    task_graph& operator=(const task_graph&) = delete;
+
+    // 运行中的图不能销毁：等它结束
+    ~task_graph() {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this] { return !running; });
+    }
+
+    // 添加节点，deps 中的节点全部完成后才会执行它
+    template<typename F>
+        requires std::invocable<std::decay_t<F>&>
+    node add(std::string name, F&& fn, std::initializer_list<node> deps = {}) {
+        check_idle();
+        nodes.push_back(Node{ std::move(name), Task(std::forward<F>(fn)), {}, 0 });
+        node id = nodes.size() - 1;
+        for (node d : deps)
+            precede(d, id);
+        return id;
+    }
+
+    // 声明 before 完成后才能执行 after
+    void precede(node before, node after) {
+        check_idle();
+        if (before >= nodes.size() || after >= nodes.size())
+            throw std::out_of_range("task_graph: no such node");
+        nodes[before].successors.push_back(after);
+        ++nodes[after].indegree;
+        validated = false;
+    }
+
+    size_t size() const noexcept { return nodes.size(); }
+
+    // 运行整张图并等待结束，有节点抛出异常时重新抛出第一个（之后还没开始的节点不再执行）。
+    // 在工作线程上调用时会顺手执行排队中的任务，不会占住线程干等
+    void run(ThreadPool& pool) {
+        start(pool, nullptr);
+        std::exception_ptr e;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (running) {
+                if (!pool.on_worker_thread()) {
+                    finished.wait(lock, [this] { return !running; });
+                    break;
+                }
+                lock.unlock();
+                bool ran = pool.run_pending_here();
+                lock.lock();
+                if (!ran)
+                    finished.wait_for(lock, std::chrono::milliseconds(1), [this] { return !running; });
+            }
+            e = std::exchange(error, nullptr);
+        }
+        if (e)
+            std::rethrow_exception(e);
+    }
+
+    // 启动后立即返回；最后一个节点完成时在那个工作线程上调用 on_done（参数为第一个异常，没有则为空）。
+    // on_done 返回前图都算在运行中，不能在 on_done 里再次运行同一张图
+    void run_async(ThreadPool& pool, std::function<void(std::exception_ptr)> on_done) {
+        start(pool, std::move(on_done));
+    }
+
+    // 最近一次运行中实际执行了的节点的计时，按节点编号排列
+    std::vector<node_trace> trace() const {
+        std::vector<node_trace> out;
+        for (const Node& n : nodes) {
+            if (n.ran)
+                out.push_back(node_trace{ &n.name, n.worker, n.start, n.end });
+        }
+        return out;
+    }
+
+    // 以 Chrome trace event 格式（chrome://tracing、Perfetto 可直接打开）输出最近一次运行，
+    // 每个工作线程一行，时间以本次运行开始为零点，单位微秒
+    void write_trace(std::ostream& os) const {
+        os << "{\"traceEvents\":[";
+        bool first = true;
+        for (const Node& n : nodes) {
+            if (!n.ran)
+                continue;
+            auto us = [this](Clock::time_point t) {
+                return std::chrono::duration<double, std::micro>(t - started).count();
+            };
+            os << (first ? "" : ",") << "\n{\"name\":\"";
+            for (char c : n.name) {
+                if (c == '"' || c == '\\')
+                    os << '\\';
+                os << c;
+            }
+            os << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << n.worker
+               << ",\"ts\":" << us(n.start) << ",\"dur\":" << us(n.end) - us(n.start) << "}";
+            first = false;
+        }
+        os << "\n]}\n";
+    }
+
+private:
+    struct Node {
+        std::string name;
+        Task fn;
+        std::vector<node> successors;
+        size_t indegree;
+        std::atomic<size_t> waiting{ 0 };  // 本次运行中还没完成的前驱数
+        bool ran = false;
+        size_t worker = 0;
+        Clock::time_point start;
+        Clock::time_point end;
+
+        Node(std::string name, Task fn, std::vector<node> successors, size_t indegree)
+            : name(std::move(name)), fn(std::move(fn)), successors(std::move(successors)), indegree(indegree) {}
+        Node(Node&& other) noexcept
+            : name(std::move(other.name)), fn(std::move(other.fn)),
+            successors(std::move(other.successors)), indegree(other.indegree) {}
+    };
+
+    void check_idle() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running)
+            throw std::logic_error("task_graph modified while running");
+    }
+
+    // 第一次运行或结构变化后做一次拓扑排序，确认没有环
+    void validate() {
+        std::vector<size_t> degree(nodes.size());
+        std::vector<node> ready;
+        for (node i = 0; i < nodes.size(); ++i) {
+            degree[i] = nodes[i].indegree;
+            if (degree[i] == 0)
+                ready.push_back(i);
+        }
+        size_t visited = 0;
+        while (!ready.empty()) {
+            node n = ready.back();
+            ready.pop_back();
+            ++visited;
+            for (node s : nodes[n].successors) {
+                if (--degree[s] == 0)
+                    ready.push_back(s);
+            }
+        }
+        if (visited != nodes.size())
+            throw std::logic_error("task_graph contains a cycle");
+        validated = true;
+    }
+
+    void start(ThreadPool& pool, std::function<void(std::exception_ptr)> on_done) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (running)
+                throw std::logic_error("task_graph is already running");
+            if (!validated)
+                validate();
+            if (!nodes.empty()) {
+                running = true;
+                error = nullptr;
+                done_callback = std::move(on_done);
+            }
+        }
+        if (nodes.empty()) {
+            if (on_done)
+                on_done(nullptr);
+            return;
+        }
+
+        failed.store(false, std::memory_order_relaxed);
+        remaining.store(nodes.size() + 1, std::memory_order_relaxed);  // 多出的1由启动方持有，投递完才释放
+        for (Node& n : nodes) {
+            n.waiting.store(n.indegree, std::memory_order_relaxed);
+            n.ran = false;
+        }
+        started = Clock::now();
+
+        // 入度在运行期间不变，边遍历边投递是安全的
+        for (node i = 0; i < nodes.size(); ++i) {
+            if (nodes[i].indegree == 0)
+                dispatch(pool, i);
+        }
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            complete();
+    }
+
+    // 执行节点 n，再把就绪的后继一个留在当前线程继续执行、其余投递出去
+    void execute(ThreadPool& pool, node n) {
+        while (n != npos) {
+            Node& cur = nodes[n];
+            if (!failed.load(std::memory_order_relaxed)) {
+                cur.worker = ThreadPool::current_index;
+                cur.start = Clock::now();
+                try {
+                    cur.fn();
+                } catch (...) {
+                    fail(std::current_exception());
+                }
+                cur.end = Clock::now();
+                cur.ran = true;
+            }
+
+            node next = npos;
+            for (node s : cur.successors) {
+                if (nodes[s].waiting.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                    continue;
+                if (next != npos)
+                    dispatch(pool, next);
+                next = s;
+            }
+
+            // 计数归零后图可能立即被销毁或重新运行，此后不能再访问任何成员
+            if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                complete();
+                return;
+            }
+            n = next;
+        }
+    }
+
+    // 把节点 n 投递到线程池。线程池拒绝时（已停止，或有界队列 Reject）把异常记为本次运行的错误，
+    // 并把 n 以及只能经由它就绪的后继都当作已完成，complete() 照常会被调用。
+    // 调用方（启动方或正在执行的节点）自己还占着 remaining 的一份，这里不会把它减到零
+    void dispatch(ThreadPool& pool, node n) {
+        try {
+            pool.post([this, &pool, n] { this->execute(pool, n); });
+        } catch (...) {
+            fail(std::current_exception());
+            std::vector<node> skipped{ n };
+            while (!skipped.empty()) {
+                node cur = skipped.back();
+                skipped.pop_back();
+                for (node s : nodes[cur].successors) {
+                    if (nodes[s].waiting.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        skipped.push_back(s);
+                }
+                remaining.fetch_sub(1, std::memory_order_acq_rel);
+            }
+        }
+    }
+
+    void fail(std::exception_ptr e) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error)
+            error = std::move(e);
+        failed.store(true, std::memory_order_relaxed);
+    }
+
+    void complete() {
+        std::function<void(std::exception_ptr)> callback;
+        std::exception_ptr e;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            callback = std::move(done_callback);
+            if (callback)
+                e = std::exchange(error, nullptr);
+        }
+        if (callback)
+            callback(e);
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+        finished.notify_all();
+    }
+
+    static constexpr node npos = static_cast<node>(-1);
+
+    std::vector<Node> nodes;
+    bool validated = false;
+    Clock::time_point started;
+
+    std::atomic<size_t> remaining{ 0 };
+    std::atomic<bool> failed{ false };
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    bool running = false;
+    std::exception_ptr error;
+    std::function<void(std::exception_ptr)> done_callback;
+};
@@ -1,5 +1,4 @@
 #include <vector>
-#include <queue>
 #include <memory>
 #include <thread>
 #include <mutex>
@@ -8,56 +7,1038 @@
 #include <functional>
 #include <stdexcept>
 #include <concepts>
+#include <atomic>
+#include <latch>
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <stop_token>
+#include <ranges>
+#include <limits>
+#include "Task.h"
+#include "Coroutine.h"
+#include "Metrics.h"
+#include "Topology.h"
+#include "MpmcQueue.h"
+#include "TimerWheel.h"
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+// 编译时定义 THREADPOOL_NO_METRICS 可去掉全部指标采集，执行路径上不再读时钟、不再写计数器；
+// stats() 仍然可用，但只有队列深度、线程数和丢弃的定时任务数
+#ifdef THREADPOOL_NO_METRICS
+inline constexpr bool metrics_enabled = false;
+#else
+inline constexpr bool metrics_enabled = true;
+#endif
+
+// 调度模式
+enum class SchedulingMode {
+    SharedQueue,   // 所有线程共享一个互斥锁保护的任务队列（原始实现）
+    WorkStealing,  // 每个线程拥有自己的双端队列，空闲线程从其他线程窃取任务
+    BoundedQueue   // 所有线程共享一个有界无锁环形队列（MpmcQueue），满时按背压策略处理
+};
+
+// 有界队列满时 enqueue/post 的处理方式
+enum class Backpressure {
+    Block,       // 阻塞提交方直到有空位（工作线程内部的提交改为就地执行，避免所有线程互相等待）
+    Reject,      // 抛出 std::runtime_error
+    CallerRuns   // 在提交方线程上直接执行
+};
+
+// 任务优先级，每个优先级对应一条独立的队列（车道）
+enum class Priority {
+    High,    // 延迟敏感的任务，如网络请求
+    Normal,  // enqueue/post 的默认优先级
+    Low      // 后台批量任务，如帧缩放
+};
+
+inline constexpr size_t priority_levels = 3;
+
+// 共享队列模式下，工作线程连续从本地缓冲取这么多个任务后去共享车道看一次
+inline constexpr size_t local_batch = 16;
+
+// 单个任务的调度选项（用于 enqueue_with / post_with）
+struct TaskOptions {
+    TaskOptions(Priority priority = Priority::Normal,
+                std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max(),
+                Task on_expire = {})
+        : priority(priority), deadline(deadline), on_expire(std::move(on_expire)) {}
+
+    Priority priority;
+    // 截止时间：出队时已过期的任务不再执行，而是交给on_expire（如果有），
+    // enqueue_with 返回的future会得到 std::future_errc::broken_promise
+    std::chrono::steady_clock::time_point deadline;
+    Task on_expire;
+};
+
+// 工作线程的CPU放置策略
+enum class Placement {
+    None,        // 不绑定，由操作系统调度
+    PinCpus,     // 第i个线程绑定到 cpu_set[i % cpu_set.size()] 这一个CPU（cpu_set为空时使用所有在线CPU）
+    SpreadNodes  // 线程轮流分配到各NUMA节点，绑定到该节点的全部CPU上（节点内仍可由系统迁移）
+};
+
+// 空闲策略：找不到任务时先自旋、再让出CPU、最后才在条件变量上休眠。
+// 突发的微任务之间间隔很短时，自旋能省掉一次futex唤醒（提交方也不必notify）；默认直接休眠
+struct IdlePolicy {
+    size_t spin = 0;   // 自旋检查次数，每次之间执行一条pause指令
+    size_t yield = 0;  // 随后 std::this_thread::yield 的次数
+};
+
+// 线程池构造选项
+struct ThreadPoolOptions {
+    size_t threads = std::thread::hardware_concurrency();
+    SchedulingMode mode = SchedulingMode::SharedQueue;
+    // 防饿死：非空的低优先级车道最多连续被跳过这么多次，之后必定被服务一次
+    size_t starvation_limit = 16;
+    Placement placement = Placement::None;
+    std::vector<int> cpu_set{};  // PinCpus 使用的CPU编号
+    IdlePolicy idle_policy{};
+    // 弹性伸缩（仅共享队列模式）：max_threads 大于 threads 时，没有空闲线程且排队任务数达到
+    // grow_threshold 就新增一个线程，直到 max_threads；新增的线程空闲 idle_timeout 后退出。
+    // 构造时创建的 threads 个线程始终保留
+    size_t max_threads = 0;
+    size_t grow_threshold = 8;
+    std::chrono::milliseconds idle_timeout{ 1000 };
+    // 有界队列模式的容量（向上取整到2的幂）和满时的处理方式
+    size_t queue_capacity = 1024;
+    Backpressure backpressure = Backpressure::Block;
+};
+
+// 单条优先级车道的统计快照
+struct LaneStats {
+    uint64_t dequeued = 0;  // 出队的任务数（含过期的）
+    uint64_t expired = 0;   // 因过期而未执行的任务数
+    std::chrono::nanoseconds wait_p50{0}, wait_p90{0}, wait_p99{0}, wait_max{0};  // 排队时间
+};
+
+// 关闭线程池时如何处理还在排队的任务
+enum class ShutdownPolicy {
+    Drain,  // 执行完所有排队的任务再退出（析构函数的行为）
+    Drop    // 丢弃排队的任务，只等正在执行的任务结束；被丢弃任务的future得到broken_promise
+};
+
+// 单个工作线程的统计
+struct WorkerStats {
+    uint64_t tasks = 0;                  // 已执行的任务数
+    std::chrono::nanoseconds busy{0};    // 执行任务的累计时间
+};
+
+// 线程池统计快照：各项分别读取，彼此之间不保证严格一致（读取时工作线程照常运行）
+struct PoolStats {
+    uint64_t submitted = 0;      // 被接受的任务数，提交时计数（含在提交方线程执行的CallerRuns，不含被拒绝的）
+    uint64_t completed = 0;      // 已执行完的任务数（同样含CallerRuns，这类任务不计入各线程的统计和直方图）
+    size_t queue_depth = 0;      // 当前排队的任务数
+    size_t threads = 0;          // 当前线程数
+    uint64_t timer_dropped = 0;  // 到期时因有界队列已满或线程池已停止而丢弃的定时任务数
+    std::vector<WorkerStats> workers;  // 按线程槽位排列
+    LatencySummary queue_wait;   // 从入队到开始执行
+    LatencySummary exec_time;    // 执行耗时
+};
+
+// 任务保存的是 F 和 Args 退化后的副本，执行时以右值调用：提交接口按这个形式检查，
+// 不能这样调用时在提交处报错，而不是在线程池内部实例化时报错
+template<typename F, typename... Args>
+concept task_invocable = std::invocable<std::decay_t<F>, std::decay_t<Args>...>;
+
+template<typename F, typename... Args>
+using task_result_t = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
 
 // 线程池类
 class ThreadPool {
 public:
-    // 构造函数，默认使用硬件支持的线程数
-    explicit ThreadPool(size_t threads = std::thread::hardware_concurrency())
-        : stop(false) {  // 初始化停止标志为false
-        // 创建指定数量的工作线程
+    // 构造函数，默认使用硬件支持的线程数和共享队列调度
+    explicit ThreadPool(size_t threads = std::thread::hardware_concurrency(),
+                        SchedulingMode mode = SchedulingMode::SharedQueue)
+        : ThreadPool(ThreadPoolOptions{ threads, mode }) {}
+
+    // 使用完整选项构造
+    explicit ThreadPool(const ThreadPoolOptions& options)
+        : mode(options.mode), starvation_limit(options.starvation_limit), idle_policy(options.idle_policy),
+          grow_threshold(options.grow_threshold), idle_timeout(options.idle_timeout),
+          backpressure(options.backpressure), stop(false) {  // 初始化停止标志为false
+        size_t threads = options.threads;
+        if (threads == 0)
+            threads = 1;  // hardware_concurrency() 可能返回0
+        core_threads = threads;
+
+        // 弹性模式下预留到 max_threads 个槽位，之后增减线程不再改变这些数组的大小
+        size_t slots = threads;
+        if (mode == SchedulingMode::SharedQueue && options.max_threads > threads)
+            slots = options.max_threads;
+
+        // 工作窃取模式下为每个线程准备一个本地队列（必须在线程启动前创建好）；
+        // 共享队列模式下它是工作线程内部提交的本地缓冲，弹性槽位也各有一个
+        if (mode == SchedulingMode::WorkStealing) {
+            for (size_t i = 0; i < threads; ++i)
+                local_queues.emplace_back(std::make_unique<LocalQueue>());
+        } else if (mode == SchedulingMode::SharedQueue) {
+            for (size_t i = 0; i < slots; ++i)
+                local_queues.emplace_back(std::make_unique<LocalQueue>());
+        }
+
+        // 有界队列模式的环形队列一次分配好，之后提交不再分配内存
+        if (mode == SchedulingMode::BoundedQueue)
+            ring = std::make_unique<MpmcQueue<QueuedTask>>(options.queue_capacity);
+
+        // 计算每个线程的CPU集合和所属NUMA节点，并为每个节点准备一个定向队列
+        worker_cpus.resize(slots);
+        worker_node.assign(slots, 0);
+        if (options.placement != Placement::None) {
+            topology = CpuTopology::detect();
+            for (size_t n = 0; n < topology.node_count(); ++n)
+                node_queues.emplace_back(std::make_unique<NodeQueue>());
+            plan_placement(options);
+        }
+
+        if constexpr (metrics_enabled)
+            worker_metrics = std::make_unique<WorkerMetrics[]>(slots);
+
+        // 创建指定数量的工作线程，其余槽位留给弹性扩容
+        workers.resize(slots);
+        slot_active.assign(slots, false);
         for (size_t i = 0; i < threads; ++i) {
-            workers.emplace_back([this] {  // 每个线程执行以下lambda函数
-                for (;;) {  // 无限循环，直到线程池停止
-                    std::function<void()> task;  // 用于存储待执行的任务
-
-                    {  // 加锁区域开始
-                        std::unique_lock<std::mutex> lock(this->queue_mutex);
-                        // 等待条件变量：当线程池停止或任务队列不为空时继续
-                        this->condition.wait(lock, [this] {
-                            return this->stop || !this->tasks.empty();
-                            });
-
-                        // 如果线程池已停止且任务队列为空，则线程退出
-                        if (this->stop && this->tasks.empty())
-                            return;
-
-                        // 从任务队列中取出一个任务
-                        task = std::move(this->tasks.front());
-                        this->tasks.pop();
-                    }  // 加锁区域结束，自动释放锁
-
-                    task();  // 执行任务
-                }
-                });
+            slot_active[i] = true;
+            workers[i] = std::thread([this, i] { this->worker_main(i); });
         }
+        live.store(threads);
     }
 
     // 向线程池添加任务（模板函数）
     template<typename F, typename... Args>
-        requires std::invocable<F, Args...>  // C++20概念：确保F可以使用Args...调用
+        requires task_invocable<F, Args...>  // C++20概念：确保F的副本可以用Args...的副本调用
     auto enqueue(F&& f, Args&&... args)
-        -> std::future<std::invoke_result_t<F, Args...>> {  // 返回任务结果的future
+        -> std::future<task_result_t<F, Args...>> {  // 返回任务结果的future
+        auto [task, res] = package(std::forward<F>(f), std::forward<Args>(args)...);
+        submit(std::move(task));
+        return res;  // 返回future对象
+    }
+
+    // 非阻塞提交：有界队列已满时返回空，不触发背压策略（此时可调用对象随之销毁）。
+    // 其他模式的队列没有上限，总是成功
+    template<typename F, typename... Args>
+        requires task_invocable<F, Args...>
+    auto try_enqueue(F&& f, Args&&... args)
+        -> std::optional<std::future<task_result_t<F, Args...>>> {
+        auto [task, res] = package(std::forward<F>(f), std::forward<Args>(args)...);
+        if (!try_submit(task))
+            return std::nullopt;
+        return std::move(res);
+    }
+
+    template<typename F, typename... Args>
+        requires task_invocable<F, Args...>
+    bool try_post(F&& f, Args&&... args) {
+        Task task([fn = std::forward<F>(f), ... params = std::forward<Args>(args)]() mutable {
+            std::invoke(std::move(fn), std::move(params)...);
+            });
+        return try_submit(task);
+    }
+
+    // 按选项（优先级、截止时间）提交任务，总是进入优先级车道
+    template<typename F, typename... Args>
+        requires task_invocable<F, Args...>
+    auto enqueue_with(TaskOptions options, F&& f, Args&&... args)
+        -> std::future<task_result_t<F, Args...>> {
+        auto [task, res] = package(std::forward<F>(f), std::forward<Args>(args)...);
+        submit_with(std::move(options), std::move(task));
+        return res;
+    }
+
+    // 按选项提交不需要结果的任务
+    template<typename F, typename... Args>
+        requires task_invocable<F, Args...>
+    void post_with(TaskOptions options, F&& f, Args&&... args) {
+        submit_with(std::move(options), Task([fn = std::forward<F>(f), ... params = std::forward<Args>(args)]() mutable {
+            std::invoke(std::move(fn), std::move(params)...);
+            }));
+    }
+
+    // 提交到指定NUMA节点的线程上执行，用于让节点N上分配的数据由节点N的线程处理。
+    // node 是内核的节点编号（与 numa_node_of_cpu、/sys/devices/system/node/nodeN 一致）。
+    // 只在 placement 不为 None 时有效；节点不存在或该节点上没有线程时退化为普通提交
+    template<typename F, typename... Args>
+        requires task_invocable<F, Args...>
+    auto enqueue_on_node(size_t node, F&& f, Args&&... args)
+        -> std::future<task_result_t<F, Args...>> {
+        auto [task, res] = package(std::forward<F>(f), std::forward<Args>(args)...);
+        submit_on_node(node, std::move(task));
+        return res;
+    }
+
+    template<typename F, typename... Args>
+        requires task_invocable<F, Args...>
+    void post_on_node(size_t node, F&& f, Args&&... args) {
+        submit_on_node(node, Task([fn = std::forward<F>(f), ... params = std::forward<Args>(args)]() mutable {
+            std::invoke(std::move(fn), std::move(params)...);
+            }));
+    }
+
+    // 提交不需要结果的任务：不创建future，小的可调用对象全程零堆分配
+    // 任务内抛出的异常不会被捕获（与std::thread一致，会导致std::terminate）
+    template<typename F, typename... Args>
+        requires task_invocable<F, Args...>
+    void post(F&& f, Args&&... args) {
+        if constexpr (sizeof...(Args) == 0) {
+            submit(Task(std::forward<F>(f)));
+        } else {
+            submit(Task([fn = std::forward<F>(f), ... params = std::forward<Args>(args)]() mutable {
+                std::invoke(std::move(fn), std::move(params)...);
+                }));
+        }
+    }
+
+    // 批量提交：range 的每个元素是一个无参可调用对象，整批只加一次锁、只唤醒一次，
+    // 返回的 future 与 range 中的顺序一一对应。有界队列模式下逐个无锁入队，
+    // 满了按背压策略处理（Reject 抛出时，之前的任务已经提交）
+    template<std::ranges::input_range R>
+        requires std::invocable<std::ranges::range_reference_t<R>>
+    auto enqueue_bulk(R&& range)
+        -> std::vector<std::future<std::invoke_result_t<std::ranges::range_reference_t<R>>>> {
+        std::vector<std::future<std::invoke_result_t<std::ranges::range_reference_t<R>>>> results;
+        std::vector<QueuedTask> batch;
+        if constexpr (std::ranges::sized_range<R>) {
+            results.reserve(std::ranges::size(range));
+            batch.reserve(std::ranges::size(range));
+        }
+        const auto now = stamp();
+        for (auto&& fn : range) {
+            auto [task, res] = package(std::forward<decltype(fn)>(fn));
+            batch.push_back(QueuedTask{ std::move(task), now });
+            results.push_back(std::move(res));
+        }
+        submit_bulk(batch);
+        return results;
+    }
+
+    template<std::ranges::input_range R>
+        requires std::invocable<std::ranges::range_reference_t<R>>
+    void post_bulk(R&& range) {
+        std::vector<QueuedTask> batch;
+        if constexpr (std::ranges::sized_range<R>)
+            batch.reserve(std::ranges::size(range));
+        const auto now = stamp();
+        for (auto&& fn : range)
+            batch.push_back(QueuedTask{ Task(std::forward<decltype(fn)>(fn)), now });
+        submit_bulk(batch);
+    }
+
+    // 延迟任务：delay 之后把任务投递到线程池（精度1ms，不会提前）。
+    // 返回的句柄可用于 cancel_timer；计时由一个独立的时间轮线程负责，不占用工作线程
+    template<typename F, typename... Args>
+        requires task_invocable<F, Args...>
+    TimerId schedule_after(TimerWheel::Clock::duration delay, F&& f, Args&&... args) {
+        return schedule_at(TimerWheel::Clock::now() + delay, std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    template<typename F, typename... Args>
+        requires task_invocable<F, Args...>
+    TimerId schedule_at(TimerWheel::Clock::time_point when, F&& f, Args&&... args) {
+        return timer_wheel().add_at(when, Task([fn = std::forward<F>(f), ... params = std::forward<Args>(args)]() mutable {
+            std::invoke(std::move(fn), std::move(params)...);
+            }));
+    }
+
+    // 周期任务：首次在 period 之后执行，之后每隔 period 执行一次，按计划时间累加不漂移。
+    // 上一次还在执行时跳过本次；需要 cancel_timer 才会停止
+    template<typename F>
+        requires std::invocable<F&>
+    TimerId schedule_every(TimerWheel::Clock::duration period, F&& f) {
+        return timer_wheel().add_every(period, Task(std::forward<F>(f)));
+    }
+
+    // 取消尚未触发的定时器，成功时返回true；已经投递到线程池的那一次不受影响
+    bool cancel_timer(TimerId id) {
+        return timers ? timers->cancel(id) : false;
+    }
+
+    // 数据并行循环：把[begin, end)按grain大小切块分给工作线程，调用线程也参与执行，
+    // 所有块完成后经由一个latch汇合，而不是每个元素一个future。
+    // fn 可以是 fn(i)（逐元素）或 fn(b, e)（处理一整块[b, e)）。
+    // 任一块抛出异常时，尚未开始的块被跳过，第一个异常在调用线程重新抛出
+    template<std::integral Index, typename F>
+        requires std::invocable<F&, Index> || std::invocable<F&, Index, Index>
+    void parallel_for(Index begin, Index end, Index grain, F&& fn) {
+        if (!(begin < end))
+            return;
+        if (grain < 1)
+            grain = 1;
+
+        const size_t total = static_cast<size_t>(end - begin);
+        const size_t step = static_cast<size_t>(grain);
+        const size_t chunks = (total + step - 1) / step;
 
-        using return_type = std::invoke_result_t<F, Args...>;  // 获取调用结果的类型
+        // 执行第c块
+        auto run_chunk = [&](size_t c) {
+            Index b = static_cast<Index>(begin + static_cast<Index>(c * step));
+            Index e = (c + 1 == chunks) ? end : static_cast<Index>(b + grain);
+            if constexpr (std::invocable<F&, Index, Index>) {
+                fn(b, e);
+            } else {
+                for (Index i = b; i < e; ++i)
+                    fn(i);
+            }
+        };
 
-        // 将任务包装成packaged_task，以便获取future
-        auto task = std::make_shared<std::packaged_task<return_type()>>(
-            std::bind(std::forward<F>(f), std::forward<Args>(args)...)
-        );
+        // 只有一块时直接在调用线程执行，不经过队列
+        if (chunks == 1) {
+            run_chunk(0);
+            return;
+        }
+
+        // 所有参与者共享的状态：下一个待领取的块、汇合用的latch、第一个异常。
+        // 用shared_ptr持有，保证排在队列后面才开始的帮手线程访问它时仍然有效
+        // （这样的帮手领不到块，不会再碰调用线程栈上的fn）
+        struct Shared {
+            explicit Shared(size_t n) : done(static_cast<std::ptrdiff_t>(n)) {}
+            std::atomic<size_t> next{0};
+            std::atomic<bool> failed{false};
+            std::latch done;
+            std::mutex error_mutex;
+            std::exception_ptr error;
+        };
+        auto shared = std::make_shared<Shared>(chunks);
+
+        // 领取并执行块，直到全部领完；每完成一块latch减一
+        auto work = [](Shared& s, size_t chunks, auto* run) {
+            for (;;) {
+                size_t c = s.next.fetch_add(1, std::memory_order_relaxed);
+                if (c >= chunks)
+                    return;
+                if (!s.failed.load(std::memory_order_relaxed)) {
+                    try {
+                        (*run)(c);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(s.error_mutex);
+                        if (!s.error)
+                            s.error = std::current_exception();
+                        s.failed.store(true, std::memory_order_relaxed);
+                    }
+                }
+                s.done.count_down();
+            }
+        };
+
+        // 调用线程自己也算一个参与者，所以最多再请 chunks-1 个帮手
+        const size_t helpers = std::min(size(), chunks - 1);
+        for (size_t i = 0; i < helpers; ++i)
+            post([shared, chunks, run = &run_chunk, work] { work(*shared, chunks, run); });
+
+        work(*shared, chunks, &run_chunk);
+        shared->done.wait();
+
+        if (shared->error)
+            std::rethrow_exception(shared->error);
+    }
+
+    // 并行归约：每块计算 map(b, e, identity) 得到部分结果，
+    // 再在调用线程中按块的顺序用 reduce 依次合并（结果与执行顺序无关）
+    template<std::integral Index, typename T, typename Map, typename Reduce>
+        requires std::invocable<Map&, Index, Index, T> && std::invocable<Reduce&, T, T>
+    T parallel_reduce(Index begin, Index end, Index grain, T identity, Map&& map, Reduce&& reduce) {
+        if (!(begin < end))
+            return identity;
+        if (grain < 1)
+            grain = 1;
+
+        const size_t total = static_cast<size_t>(end - begin);
+        const size_t step = static_cast<size_t>(grain);
+        const size_t chunks = (total + step - 1) / step;
+
+        std::vector<T> partial(chunks, identity);
+        parallel_for(size_t(0), chunks, size_t(1), [&](size_t c) {
+            Index b = static_cast<Index>(begin + static_cast<Index>(c * step));
+            Index e = (c + 1 == chunks) ? end : static_cast<Index>(b + grain);
+            partial[c] = map(b, e, identity);
+            });
+
+        T result = std::move(identity);
+        for (T& p : partial)
+            result = reduce(std::move(result), std::move(p));
+        return result;
+    }
+
+    // 协程调度：co_await pool.schedule() 挂起当前协程，并在线程池的某个工作线程上恢复它。
+    // 恢复操作通过post提交，与普通任务共用队列
+    auto schedule() noexcept {
+        struct awaiter {
+            ThreadPool& pool;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h) { pool.post([h] { h.resume(); }); }
+            void await_resume() const noexcept {}
+        };
+        return awaiter{ *this };
+    }
+
+    // 当前调度模式
+    SchedulingMode scheduling_mode() const noexcept { return mode; }
+
+    // 当前工作线程数量（弹性模式下随负载变化）
+    size_t size() const noexcept { return live.load(); }
+
+    // 有CPU的NUMA节点数（placement 为 None 时为0）以及第i个线程所在节点的内核编号；
+    // 各节点的编号见 cpu_topology().node_ids
+    size_t node_count() const noexcept { return node_queues.size(); }
+    size_t node_of_worker(size_t i) const noexcept {
+        return node_queues.empty() ? 0 : static_cast<size_t>(topology.node_ids[worker_node[i]]);
+    }
+
+    // 检测到的CPU拓扑（placement 为 None 时为空）
+    const CpuTopology& cpu_topology() const noexcept { return topology; }
+
+    // 某条优先级车道的排队时间分位数、出队和过期计数，可在任意线程随时读取；
+    // 定义 THREADPOOL_NO_METRICS 时只有过期计数
+    LaneStats lane_stats(Priority priority) const {
+        const size_t lane = static_cast<size_t>(priority);
+        const LatencyHistogram& h = lane_wait[lane];
+        LaneStats s;
+        s.dequeued = h.count();
+        s.expired = lane_expired[lane].load(std::memory_order_relaxed);
+        s.wait_p50 = std::chrono::nanoseconds(h.percentile(50));
+        s.wait_p90 = std::chrono::nanoseconds(h.percentile(90));
+        s.wait_p99 = std::chrono::nanoseconds(h.percentile(99));
+        s.wait_max = std::chrono::nanoseconds(h.max());
+        return s;
+    }
+
+    // 统计快照：只读原子计数器，不加锁、不打断工作线程，可以高频轮询
+    PoolStats stats() const {
+        PoolStats s;
+        s.threads = size();
+        s.timer_dropped = timer_dropped.load(std::memory_order_relaxed);
+        // 提交方先发布任务再给pending加一，消费方可能先减，pending会短暂回绕：按有符号数读并截到0
+        const auto queued = static_cast<std::ptrdiff_t>(pending.load());
+        s.queue_depth = lane_count.load() + (queued > 0 ? static_cast<size_t>(queued) : 0);
+        for (const auto& q : node_queues)
+            s.queue_depth += q->count.load();
+
+        if constexpr (metrics_enabled) {
+            // 各线程的直方图分开记录（避免共享缓存行），读取时合并
+            auto merged = std::make_unique<LatencyHistogram[]>(2);
+            s.workers.resize(workers.size());
+            for (size_t i = 0; i < workers.size(); ++i) {
+                const WorkerMetrics& m = worker_metrics[i];
+                s.workers[i].tasks = m.tasks.load(std::memory_order_relaxed);
+                s.workers[i].busy = std::chrono::nanoseconds(m.busy_ns.load(std::memory_order_relaxed));
+                s.completed += s.workers[i].tasks;
+                merged[0].merge(m.queue_wait);
+                merged[1].merge(m.exec_time);
+            }
+            s.completed += caller_completed.load(std::memory_order_relaxed);
+            for (const SubmitShard& shard : submit_counts)
+                s.submitted += shard.count.load(std::memory_order_relaxed);
+            s.queue_wait = merged[0].summary();
+            s.exec_time = merged[1].summary();
+        }
+        return s;
+    }
+
+    // 停止接受新任务并等待所有线程退出，返回被丢弃的任务数。
+    // 只能在池外的线程调用；重复调用直接返回0。
+    // 注意：被丢弃的 schedule() 恢复任务对应的协程不会再被恢复；尚未到期的定时器同样被丢弃（不计入返回值）
+    size_t shutdown(ShutdownPolicy policy = ShutdownPolicy::Drain) {
+        std::vector<Task> dropped;  // 在锁外销毁，任务的析构可能再访问线程池
+        {  // 加锁区域开始
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            if (stop)
+                return 0;
+            stop = true;  // 设置停止标志
+
+            if (policy == ShutdownPolicy::Drop) {
+                for (auto& lane : lanes) {
+                    while (!lane.empty()) {
+                        dropped.push_back(std::move(lane.front().task));
+                        lane.pop_front();
+                        lane_count.fetch_sub(1);
+                    }
+                }
+                for (auto& q : node_queues) {
+                    while (!q->tasks.empty()) {
+                        dropped.push_back(std::move(q->tasks.front().task));
+                        q->tasks.pop_front();
+                        q->count.fetch_sub(1);
+                    }
+                }
+            }
+        }  // 加锁区域结束，自动释放锁
+
+        // 先停掉时间轮线程：此后不会再有到期任务投递进来（stop之后投递的会被丢弃）
+        timers.reset();
+
+        if (policy == ShutdownPolicy::Drop) {
+            for (auto& q : local_queues) {
+                std::lock_guard<std::mutex> lock(q->mutex);
+                while (!q->tasks.empty()) {
+                    dropped.push_back(std::move(q->tasks.front().task));
+                    q->tasks.pop_front();
+                    pending.fetch_sub(1);
+                }
+            }
+            QueuedTask item;
+            while (ring && pop_ring(item)) {
+                dropped.push_back(std::move(item.task));
+                pending.fetch_sub(1);
+            }
+        }
+
+        condition.notify_all();  // 通知所有线程
+        {
+            // 唤醒因有界队列已满而阻塞的提交方，让它们看到stop后抛出异常
+            std::lock_guard<std::mutex> lock(space_mutex);
+        }
+        space_available.notify_all();
+        for (std::thread& worker : workers)
+            if (worker.joinable())  // 未使用的弹性槽位没有线程；已退出的线程同样需要join
+                worker.join();  // 等待所有线程结束
+
+        size_t count = dropped.size();
+        dropped.clear();
+        return count;
+    }
+
+    // 析构函数：执行完排队的任务再退出
+    ~ThreadPool() {
+        shutdown(ShutdownPolicy::Drain);
+    }
+
+private:
+    friend class task_group;
+    friend class task_graph;
+    using Clock = std::chrono::steady_clock;
+
+    // 当前线程是否是本池的工作线程
+    bool on_worker_thread() const noexcept { return current_pool == this; }
+
+    // 时间轮在第一次调度定时任务时才创建，不用定时器的线程池不多一个线程。
+    // 到期的任务只做非阻塞入队，不受背压策略影响：时间轮线程既不会在满队列上阻塞，
+    // 也不会替线程池执行任务（那样会拖住其他所有定时器）。有界队列已满或线程池已停止时丢弃并计数
+    TimerWheel& timer_wheel() {
+        if (stop.load(std::memory_order_relaxed))
+            throw std::runtime_error("schedule on stopped ThreadPool");
+        std::call_once(timers_once, [this] {
+            timers = std::make_unique<TimerWheel>([this](Task task) {
+                bool queued = false;
+                try {
+                    queued = this->try_submit(task);
+                } catch (const std::runtime_error&) {
+                    // 只可能来自线程池已停止：任务没有执行过
+                }
+                if (!queued)
+                    timer_dropped.fetch_add(1, std::memory_order_relaxed);
+                });
+            });
+        return *timers;
+    }
+
+    // 在当前工作线程上顺手执行一个排队中的任务，没有可执行的任务时返回false。
+    // task_group::wait 在工作线程上调用它，避免工作线程干等子任务导致线程耗尽
+    bool run_pending_here() {
+        if (current_pool != this)
+            return false;
+        const size_t index = current_index;
+        QueuedTask item;
+        bool found = try_pop_lane(item, false) || try_pop_node(index, item);
+        if (!found) {
+            if (ring)
+                found = pop_ring(item);
+            else if (!local_queues.empty())
+                found = pop_local(index, item) || steal(index, item);
+            if (found)
+                pending.fetch_sub(1);
+        }
+        if (found)
+            run(index, item);
+        return found;
+    }
+
+    // 队列中的任务，附带入队时间用于统计排队时长
+    struct QueuedTask {
+        Task task;
+        Clock::time_point enqueued;
+    };
+
+    // 每个工作线程独占的计数器和直方图，按缓存行对齐，记录时没有跨线程争用
+    struct alignas(64) WorkerMetrics {
+        std::atomic<uint64_t> tasks{0};
+        std::atomic<uint64_t> busy_ns{0};
+        LatencyHistogram queue_wait;
+        LatencyHistogram exec_time;
+    };
+
+    // 提交计数按线程分片，各提交方大多落在不同的缓存行上；stats() 读取时求和
+    static constexpr size_t submit_shard_count = 16;
+    struct alignas(64) SubmitShard {
+        std::atomic<uint64_t> count{0};
+    };
+
+    // 任务被接受后计数；关闭指标时什么也不做
+    void count_submitted(size_t n) noexcept {
+        if constexpr (metrics_enabled) {
+            static std::atomic<size_t> next_shard{0};
+            thread_local const size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % submit_shard_count;
+            submit_counts[shard].count.fetch_add(n, std::memory_order_relaxed);
+        }
+    }
+
+    // 入队时间戳；关闭指标时不读时钟
+    static Clock::time_point stamp() noexcept {
+        if constexpr (metrics_enabled)
+            return Clock::now();
+        else
+            return Clock::time_point();
+    }
+
+    // 在第index个工作线程上执行任务，并记录排队时间和执行时间
+    void run(size_t index, QueuedTask& item) {
+        if constexpr (metrics_enabled) {
+            WorkerMetrics& m = worker_metrics[index];
+            auto start = Clock::now();
+            m.queue_wait.record(start - item.enqueued);
+            item.task();
+            auto elapsed = Clock::now() - start;
+            m.exec_time.record(elapsed);
+            m.busy_ns.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+                                std::memory_order_relaxed);
+            m.tasks.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            item.task();
+        }
+    }
+
+    // 把可调用对象和参数打包成Task，并返回与之关联的future
+    template<typename F, typename... Args>
+    static auto package(F&& f, Args&&... args) {
+        using return_type = task_result_t<F, Args...>;  // 获取调用结果的类型
+
+        // promise的共享状态从BlockPool分配，稳态下不再调用malloc
+        std::promise<return_type> promise(std::allocator_arg, PoolAllocator<return_type>{});
 
         // 获取任务的future对象
-        std::future<return_type> res = task->get_future();
+        std::future<return_type> res = promise.get_future();
+
+        // 用lambda直接捕获可调用对象和参数（替代std::bind + shared_ptr<packaged_task>），
+        // 小的任务整体放进Task的内联缓冲区
+        Task task([promise = std::move(promise),
+                   fn = std::forward<F>(f),
+                   ... params = std::forward<Args>(args)]() mutable {
+            try {
+                if constexpr (std::is_void_v<return_type>) {
+                    std::invoke(std::move(fn), std::move(params)...);
+                    promise.set_value();
+                } else {
+                    promise.set_value(std::invoke(std::move(fn), std::move(params)...));
+                }
+            } catch (...) {
+                promise.set_exception(std::current_exception());
+            }
+            });
+        return std::pair<Task, std::future<return_type>>(std::move(task), std::move(res));
+    }
+
+    // 定向到某个NUMA节点的任务队列，由queue_mutex保护
+    struct NodeQueue {
+        TaskQueue<QueuedTask> tasks;
+        std::atomic<size_t> count{0};
+    };
+
+    // 按放置策略计算每个线程的CPU集合和节点
+    void plan_placement(const ThreadPoolOptions& options) {
+        const size_t threads = worker_cpus.size();
+        if (options.placement == Placement::SpreadNodes) {
+            for (size_t i = 0; i < threads; ++i) {
+                worker_node[i] = i % topology.node_count();
+                worker_cpus[i] = topology.nodes[worker_node[i]];
+            }
+            return;
+        }
+
+        // PinCpus：每个线程一个CPU，节点取该CPU所在的节点
+        const std::vector<int>& cpus = options.cpu_set.empty() ? topology.cpus : options.cpu_set;
+        for (size_t i = 0; i < threads && !cpus.empty(); ++i) {
+            int cpu = cpus[i % cpus.size()];
+            worker_cpus[i] = { cpu };
+            for (size_t n = 0; n < topology.node_count(); ++n)
+                if (std::find(topology.nodes[n].begin(), topology.nodes[n].end(), cpu) != topology.nodes[n].end())
+                    worker_node[i] = n;
+        }
+    }
+
+    // 工作线程入口：先完成绑定，再进入对应模式的主循环
+    void worker_main(size_t index) {
+        current_pool = this;
+        current_index = index;
+        if (!worker_cpus[index].empty())
+            CpuTopology::pin_current_thread(worker_cpus[index]);
+
+        if (mode != SchedulingMode::SharedQueue)
+            worker_loop_stealing(index);
+        else
+            worker_loop_shared(index);
+    }
+
+    // 提交到节点队列；节点无效或没有线程时按普通任务提交
+    void submit_on_node(size_t node_id, Task task) {
+        // 内核编号换算成节点队列的下标；只看常驻线程：弹性线程可能随时退出
+        const size_t node = node_id > static_cast<size_t>(std::numeric_limits<int>::max())
+            ? CpuTopology::npos : topology.index_of_node(static_cast<int>(node_id));
+        auto core_end = worker_node.begin() + static_cast<std::ptrdiff_t>(core_threads);
+        if (node >= node_queues.size() || std::find(worker_node.begin(), core_end, node) == core_end) {
+            submit(std::move(task));
+            return;
+        }
+
+        bool wake;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            if (stop)
+                throw std::runtime_error("enqueue on stopped ThreadPool");
+            node_queues[node]->tasks.push_back(QueuedTask{ std::move(task), stamp() });
+            node_queues[node]->count.fetch_add(1);
+            wake = idle.load() > 0;
+        }
+        count_submitted(1);
+        // 所有线程共用一个条件变量，notify_one可能唤醒别的节点的线程，这里只能全部唤醒
+        if (wake)
+            condition.notify_all();
+    }
+
+    // 本节点队列是否有任务
+    bool node_has_work(size_t index) const {
+        return !node_queues.empty() && node_queues[worker_node[index]]->count.load() > 0;
+    }
+
+    // 从本节点队列取任务（调用方须持有queue_mutex）
+    bool pop_node(size_t index, QueuedTask& item) {
+        if (node_queues.empty())
+            return false;
+        NodeQueue& q = *node_queues[worker_node[index]];
+        if (q.tasks.empty())
+            return false;
+        item = std::move(q.tasks.front());
+        q.tasks.pop_front();
+        q.count.fetch_sub(1);
+        return true;
+    }
+
+    // 加锁后尝试从本节点队列取任务（工作窃取模式使用）
+    bool try_pop_node(size_t index, QueuedTask& item) {
+        if (!node_has_work(index))
+            return false;
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        return pop_node(index, item);
+    }
+
+    // 工作窃取模式下每个线程私有的双端队列：
+    // 所有者从尾部取（LIFO，缓存友好），窃取者从头部取（FIFO，先拿最老的任务）
+    // 每个队列有自己的锁，竞争被分散到N把锁上，而不是全部挤在queue_mutex上
+    struct LocalQueue {
+        std::mutex mutex;
+        TaskQueue<QueuedTask> tasks;
+    };
+
+    // 把任务放入队列并唤醒工作线程（enqueue和post共用）
+    // 共享队列模式进入Normal车道（工作线程内部的提交进入自己的本地缓冲）；
+    // 工作窃取模式进入各线程的本地队列；有界队列模式进入环形队列
+    void submit(Task task) {
+        if (mode == SchedulingMode::WorkStealing || (mode == SchedulingMode::SharedQueue && current_pool == this)) {
+            push_stealing(std::move(task));
+        } else if (mode == SchedulingMode::BoundedQueue) {
+            push_bounded(std::move(task));
+        } else {
+            push_lane(Priority::Normal, std::move(task));
+        }
+        count_submitted(1);
+    }
+
+    // 批量提交：本地队列或共享车道整批加一次锁；有休眠的线程时只在最后唤醒一次
+    void submit_bulk(std::vector<QueuedTask>& batch) {
+        if (batch.empty())
+            return;
+        if (stop.load(std::memory_order_relaxed))
+            throw std::runtime_error("enqueue on stopped ThreadPool");
+        const size_t n = batch.size();
+
+        if (mode == SchedulingMode::BoundedQueue) {
+            size_t pushed = 0;
+            for (QueuedTask& item : batch) {
+                if (ring->try_push(item)) {
+                    ++pushed;
+                    continue;
+                }
+                // 队列满：先让已入队的任务可见，再按背压策略逐个处理剩下的
+                pending.fetch_add(pushed);
+                count_submitted(pushed);
+                pushed = 0;
+                wake_for(n);
+                push_bounded(std::move(item.task));
+                count_submitted(1);
+            }
+            pending.fetch_add(pushed);
+            count_submitted(pushed);
+            wake_for(n);
+            return;
+        }
+
+        if (mode == SchedulingMode::WorkStealing || current_pool == this) {
+            // 工作线程内部的批量提交进入自己的本地队列；外部的整批放进一个本地队列，由其他线程窃取
+            size_t target = current_pool == this ? current_index
+                : next_queue.fetch_add(1, std::memory_order_relaxed) % local_queues.size();
+            {
+                std::lock_guard<std::mutex> lock(local_queues[target]->mutex);
+                reserve_local(n);
+                for (QueuedTask& item : batch)
+                    local_queues[target]->tasks.push_back(std::move(item));
+            }
+            count_submitted(n);
+            wake_for(n);
+            return;
+        }
+
+        bool wake;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            if (stop)
+                throw std::runtime_error("enqueue on stopped ThreadPool");
+            auto& lane = lanes[static_cast<size_t>(Priority::Normal)];
+            for (QueuedTask& item : batch)
+                lane.push_back(std::move(item));
+            lane_count.fetch_add(n);
+            wake = idle.load() > 0;
+            if (!wake && lane_count.load() >= grow_threshold)
+                grow_locked();
+        }
+        count_submitted(n);
+        if (wake) {
+            if (n == 1)
+                condition.notify_one();
+            else
+                condition.notify_all();
+        }
+    }
+
+    // 无锁入队之后唤醒休眠的线程：一个任务唤醒一个，一批任务全部唤醒（它们会去窃取）
+    void wake_for(size_t n) {
+        if (idle.load() == 0)
+            return;
+        { std::lock_guard<std::mutex> lock(queue_mutex); }
+        if (n == 1)
+            condition.notify_one();
+        else
+            condition.notify_all();
+    }
+
+    // 尝试提交一次；只有有界队列会失败，失败时task保持不变
+    bool try_submit(Task& task) {
+        if (mode != SchedulingMode::BoundedQueue) {
+            submit(std::move(task));
+            return true;
+        }
+        if (stop.load(std::memory_order_relaxed))
+            throw std::runtime_error("enqueue on stopped ThreadPool");
+        QueuedTask item{ std::move(task), stamp() };
+        if (!ring->try_push(item)) {
+            task = std::move(item.task);
+            return false;
+        }
+        after_ring_push();
+        count_submitted(1);
+        return true;
+    }
+
+    // 有界队列模式下提交任务，队列满时按背压策略处理
+    void push_bounded(Task task) {
+        if (stop.load(std::memory_order_relaxed))
+            throw std::runtime_error("enqueue on stopped ThreadPool");
+
+        QueuedTask item{ std::move(task), stamp() };
+        if (ring->try_push(item)) {
+            after_ring_push();
+            return;
+        }
+
+        Backpressure policy = backpressure;
+        if (policy == Backpressure::Block && current_pool == this)
+            policy = Backpressure::CallerRuns;  // 工作线程阻塞等自己腾空间可能死锁
+
+        switch (policy) {
+        case Backpressure::Reject:
+            throw std::runtime_error("ThreadPool queue is full");
+        case Backpressure::CallerRuns:
+            item.task();
+            if constexpr (metrics_enabled)
+                caller_completed.fetch_add(1, std::memory_order_relaxed);
+            return;
+        case Backpressure::Block:
+            break;
+        }
+
+        // 先短暂自旋，仍满再在space_available上等待；
+        // 登记blocked再检查是否有空位，与消费方“先出队再读blocked”配对，不会丢失唤醒
+        for (;;) {
+            for (int i = 0; i < 64; ++i) {
+                if (ring->try_push(item)) {
+                    after_ring_push();
+                    return;
+                }
+                cpu_relax();
+            }
+            std::unique_lock<std::mutex> lock(space_mutex);
+            blocked_producers.fetch_add(1);
+            space_available.wait(lock, [this] {
+                return stop.load() || ring->size_approx() < ring->capacity();
+                });
+            blocked_producers.fetch_sub(1);
+            if (stop.load())
+                throw std::runtime_error("enqueue on stopped ThreadPool");
+        }
+    }
+
+    // 任务进入环形队列后：计数并在有休眠线程时唤醒一个
+    void after_ring_push() {
+        pending.fetch_add(1);
+        if (idle.load() > 0) {
+            { std::lock_guard<std::mutex> lock(queue_mutex); }
+            condition.notify_one();
+        }
+    }
+
+    // 从环形队列取任务，腾出的空位交给阻塞中的提交方
+    bool pop_ring(QueuedTask& item) {
+        if (!ring->try_pop(item))
+            return false;
+        if (blocked_producers.load() > 0) {
+            { std::lock_guard<std::mutex> lock(space_mutex); }
+            space_available.notify_one();
+        }
+        return true;
+    }
+
+    // 带选项的提交：有截止时间的任务外面再包一层，出队执行前先检查是否过期
+    void submit_with(TaskOptions options, Task task) {
+        const size_t lane = static_cast<size_t>(options.priority);
+        if (options.deadline != Clock::time_point::max()) {
+            task = Task([this, lane, deadline = options.deadline,
+                         inner = std::move(task), on_expire = std::move(options.on_expire)]() mutable {
+                if (Clock::now() > deadline) {
+                    // 不执行inner：它随包装一起销毁，enqueue_with的future得到broken_promise
+                    lane_expired[lane].fetch_add(1, std::memory_order_relaxed);
+                    if (on_expire)
+                        on_expire();
+                    return;
+                }
+                inner();
+                });
+        }
+        push_lane(options.priority, std::move(task));
+        count_submitted(1);
+    }
+
+    // 放入指定优先级车道
+    void push_lane(Priority priority, Task task) {
+        bool wake;
         {  // 加锁区域开始
             std::unique_lock<std::mutex> lock(queue_mutex);
 
@@ -65,31 +1046,454 @@ public:
             if (stop)
                 throw std::runtime_error("enqueue on stopped ThreadPool");
 
-            // 将任务添加到队列（使用lambda包装packaged_task）
-            tasks.emplace([task]() { (*task)(); });
+            lanes[static_cast<size_t>(priority)].push_back(QueuedTask{ std::move(task), stamp() });
+            lane_count.fetch_add(1);
+
+            // 线程在持锁时登记idle，所以这里读到的idle是准确的：
+            // 没有休眠的线程时，忙碌或自旋中的线程自己会看到新任务，不必notify
+            wake = idle.load() > 0;
+            if (!wake && lane_count.load() >= grow_threshold)
+                grow_locked();
         }  // 加锁区域结束，自动释放锁
 
-        condition.notify_one();  // 通知一个等待的线程有新任务
-        return res;  // 返回future对象
+        if (wake)
+            condition.notify_one();  // 通知一个等待的线程有新任务
     }
 
-    // 析构函数
-    ~ThreadPool() {
-        {  // 加锁区域开始
+    // 弹性扩容：启动一个空闲槽位上的线程（调用方须持有queue_mutex）
+    void grow_locked() {
+        for (size_t i = core_threads; i < workers.size(); ++i) {
+            if (slot_active[i])
+                continue;
+            // 槽位上可能是已经退休的线程：它在持锁时让出槽位，之后不再碰任何共享状态，可以直接join
+            if (workers[i].joinable())
+                workers[i].join();
+            slot_active[i] = true;
+            live.fetch_add(1);
+            workers[i] = std::thread([this, i] { this->worker_main(i); });
+            return;
+        }
+    }
+
+    // 执行一条pause指令，降低自旋时的功耗和对超线程兄弟核的干扰
+    static void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        _mm_pause();
+#elif defined(__aarch64__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    // 休眠前按空闲策略先自旋、再yield，期间一旦看到任务（或停止）就返回
+    template<typename Ready>
+    void spin_until(Ready ready) const {
+        for (size_t i = 0; i < idle_policy.spin; ++i) {
+            if (ready())
+                return;
+            cpu_relax();
+        }
+        for (size_t i = 0; i < idle_policy.yield; ++i) {
+            if (ready())
+                return;
+            std::this_thread::yield();
+        }
+    }
+
+    // 按优先级从车道中取出一个任务（调用方须持有queue_mutex）
+    // 通常取最高优先级的非空车道；但某条非空车道被连续跳过 starvation_limit 次后，下一次必定轮到它。
+    // high_only 为真时只接受High车道的任务（工作窃取模式下用于让高优先级任务插到本地任务之前）
+    bool pop_lane(QueuedTask& item, bool high_only) {
+        size_t chosen = priority_levels;
+        for (size_t l = 0; l < priority_levels; ++l) {
+            if (!lanes[l].empty() && lane_skips[l] >= starvation_limit) {
+                chosen = l;  // 已经饿太久的车道优先
+                break;
+            }
+        }
+        if (chosen == priority_levels) {
+            for (size_t l = 0; l < priority_levels; ++l) {
+                if (!lanes[l].empty()) {
+                    chosen = l;
+                    break;
+                }
+            }
+        }
+        if (chosen == priority_levels || (high_only && chosen != static_cast<size_t>(Priority::High)))
+            return false;
+
+        // 被跳过的非空车道累计一次，被服务的车道清零
+        for (size_t l = 0; l < priority_levels; ++l) {
+            if (l == chosen)
+                lane_skips[l] = 0;
+            else if (!lanes[l].empty())
+                ++lane_skips[l];
+        }
+
+        QueuedTask& entry = lanes[chosen].front();
+        if constexpr (metrics_enabled)
+            lane_wait[chosen].record(Clock::now() - entry.enqueued);
+        item = std::move(entry);
+        lanes[chosen].pop_front();
+        lane_count.fetch_sub(1);
+        return true;
+    }
+
+    // 加锁后尝试从车道取任务（工作窃取模式使用）
+    bool try_pop_lane(QueuedTask& item, bool high_only) {
+        if (lane_count.load() == 0)
+            return false;
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        return pop_lane(item, high_only);
+    }
+
+    // 共享队列模式的工作线程主循环
+    void worker_loop_shared(size_t index) {
+        auto ready = [this, index] {
+            return this->stop || this->lane_count.load() > 0 || this->pending.load() > 0 || this->node_has_work(index);
+        };
+        const bool elastic = index >= core_threads;
+        size_t local_streak = 0;
+
+        for (;;) {  // 无限循环，直到线程池停止
+            QueuedTask item;  // 用于存储待执行的任务
+
+            // 本线程提交的后续任务在自己的本地缓冲里，取的时候不碰queue_mutex；
+            // 连续取了local_batch个之后去共享车道看一次，免得其他车道被饿死
+            if (local_streak < local_batch && this->pop_local(index, item)) {
+                ++local_streak;
+                this->pending.fetch_sub(1);
+                this->run(index, item);
+                continue;
+            }
+            local_streak = 0;
+            this->spin_until(ready);
+            bool found;
+
+            {  // 加锁区域开始
+                std::unique_lock<std::mutex> lock(this->queue_mutex);
+                // 等待条件变量：当线程池停止或任务队列不为空时继续
+                if (!ready()) {
+                    this->idle.fetch_add(1);
+                    bool woken = true;
+                    if (elastic)
+                        woken = this->condition.wait_for(lock, this->idle_timeout, ready);
+                    else
+                        this->condition.wait(lock, ready);
+                    this->idle.fetch_sub(1);
+
+                    // 弹性线程空闲超时：让出槽位并退出
+                    if (!woken) {
+                        this->slot_active[index] = false;
+                        this->live.fetch_sub(1);
+                        return;
+                    }
+                }
+
+                // 如果线程池已停止且任务队列为空，则线程退出
+                if (this->stop && this->lane_count.load() == 0 && this->pending.load() == 0 && !this->node_has_work(index))
+                    return;
+
+                // 先取定向到本节点的任务，再按优先级从车道中取
+                found = this->pop_node(index, item) || this->pop_lane(item, false);
+            }  // 加锁区域结束，自动释放锁
+
+            // 共享车道是空的，任务在某个线程的本地缓冲里：去窃取（对方正在执行长任务时不会一直积压）
+            if (!found) {
+                if (!this->pop_local(index, item) && !this->steal(index, item))
+                    continue;
+                this->pending.fetch_sub(1);
+            }
+
+            this->run(index, item);  // 执行任务
+        }
+    }
+
+    // 工作窃取模式的工作线程主循环（有界队列模式复用它，只是把本地队列和窃取换成环形队列）
+    void worker_loop_stealing(size_t index) {
+        for (;;) {
+            QueuedTask item;
+            // 高优先级车道和定向到本节点的任务插到本地任务之前
+            if (try_pop_lane(item, true) || try_pop_node(index, item)) {
+                run(index, item);
+                continue;
+            }
+            if (ring ? pop_ring(item) : (pop_local(index, item) || steal(index, item))) {
+                pending.fetch_sub(1);
+                run(index, item);
+                continue;
+            }
+            if (try_pop_lane(item, false)) {
+                run(index, item);
+                continue;
+            }
+
+            // 本地和其他队列都没有任务，按空闲策略自旋一会儿，仍没有任务再休眠
+            auto ready = [this, index] {
+                return stop || pending.load() > 0 || lane_count.load() > 0 || node_has_work(index);
+            };
+            spin_until(ready);
+            if (pending.load() > 0 || lane_count.load() > 0 || node_has_work(index))
+                continue;
+
             std::unique_lock<std::mutex> lock(queue_mutex);
-            stop = true;  // 设置停止标志
-        }  // 加锁区域结束，自动释放锁
+            // 先登记为空闲再检查pending：与push_stealing中“先pending++再读idle”配对，
+            // 保证不会出现任务已入队而线程仍在休眠的丢失唤醒
+            idle.fetch_add(1);
+            condition.wait(lock, ready);
+            idle.fetch_sub(1);
 
-        condition.notify_all();  // 通知所有线程
-        for (std::thread& worker : workers)
-            worker.join();  // 等待所有线程结束
+            // 停止且所有任务都已执行完毕，线程退出
+            if (stop && pending.load() == 0 && lane_count.load() == 0 && !node_has_work(index))
+                return;
+        }
     }
 
-private:
-    std::vector<std::thread> workers;  // 工作线程集合
-    std::queue<std::function<void()>> tasks;  // 任务队列
+    // 工作窃取模式下提交任务
+    void push_stealing(Task task) {
+        size_t target;
+        if (current_pool == this) {
+            target = current_index;  // 来自本池工作线程的提交进入自己的本地队列
+        } else {
+            // 外部线程的提交轮询分散到各个本地队列
+            target = next_queue.fetch_add(1, std::memory_order_relaxed) % local_queues.size();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(local_queues[target]->mutex);
+            reserve_local(1);
+            local_queues[target]->tasks.push_back(QueuedTask{ std::move(task), stamp() });
+        }
+
+        // 只有存在休眠线程时才需要碰queue_mutex并唤醒
+        if (idle.load() > 0) {
+            { std::lock_guard<std::mutex> lock(queue_mutex); }
+            condition.notify_one();
+        }
+    }
+
+    // 放入本地队列前（调用方持有该队列的锁）先把任务计入pending，再检查stop。
+    // 工作线程退出前先看到stop、再确认pending为0；两边都是顺序一致的原子操作，
+    // 要么这里看到stop而拒绝提交，要么退出检查看到pending不为0而继续取任务，任务不会被丢下
+    void reserve_local(size_t n) {
+        pending.fetch_add(n);
+        if (stop.load()) {
+            pending.fetch_sub(n);
+            throw std::runtime_error("enqueue on stopped ThreadPool");
+        }
+    }
+
+    // 从自己的本地队列尾部取任务
+    bool pop_local(size_t index, QueuedTask& item) {
+        LocalQueue& q = *local_queues[index];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty())
+            return false;
+        item = std::move(q.tasks.back());
+        q.tasks.pop_back();
+        return true;
+    }
+
+    // 依次尝试从其他线程的本地队列头部窃取任务
+    bool steal(size_t index, QueuedTask& item) {
+        const size_t n = local_queues.size();
+        for (size_t k = 1; k < n; ++k) {
+            LocalQueue& q = *local_queues[(index + k) % n];
+            std::unique_lock<std::mutex> lock(q.mutex, std::try_to_lock);
+            if (!lock.owns_lock() || q.tasks.empty())
+                continue;  // 对方正忙或为空，换下一个，避免在锁上排队
+            item = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            return true;
+        }
+        // try_lock可能漏掉被短暂占用的队列，最后再阻塞地检查一遍
+        for (size_t k = 1; k < n; ++k) {
+            LocalQueue& q = *local_queues[(index + k) % n];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.tasks.empty())
+                continue;
+            item = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    SchedulingMode mode;  // 调度模式，构造后不再改变
+    size_t starvation_limit;  // 低优先级车道最多连续被跳过的次数
+    IdlePolicy idle_policy;   // 休眠前的自旋/yield次数
+    size_t grow_threshold;    // 弹性扩容的排队任务数阈值
+    std::chrono::milliseconds idle_timeout;  // 弹性线程空闲多久后退出
+
+    std::vector<std::thread> workers;  // 工作线程槽位（弹性模式下包含未启动和已退出的）
+    std::vector<bool> slot_active;     // 槽位上是否有运行中的线程，由queue_mutex保护
+    size_t core_threads = 0;           // 常驻线程数，前core_threads个槽位始终有线程
+    std::atomic<size_t> live{0};       // 运行中的线程数
+    std::unique_ptr<WorkerMetrics[]> worker_metrics;  // 每个槽位一份（关闭指标时为空）
+    SubmitShard submit_counts[submit_shard_count];    // 已接受的任务数，按提交线程分片
+    std::atomic<uint64_t> caller_completed{0};        // 队列满时在提交方线程上执行完的任务数
+
+    CpuTopology topology;                                  // 检测到的CPU拓扑
+    std::vector<std::vector<int>> worker_cpus;             // 每个线程绑定的CPU集合（空表示不绑定）
+    std::vector<size_t> worker_node;                       // 每个线程所在NUMA节点在 topology.nodes 中的下标
+    std::vector<std::unique_ptr<NodeQueue>> node_queues;   // 每个节点的定向队列
+
+    // 优先级车道，由queue_mutex保护（共享队列模式的全部任务、以及所有enqueue_with/post_with的任务）
+    TaskQueue<QueuedTask> lanes[priority_levels];
+    size_t lane_skips[priority_levels] = {};         // 各车道非空却被跳过的连续次数
+    std::atomic<size_t> lane_count{0};               // 所有车道中的任务总数
+    LatencyHistogram lane_wait[priority_levels];     // 各车道的排队时间分布
+    std::atomic<uint64_t> lane_expired[priority_levels] = {};  // 各车道过期未执行的任务数
+
+    std::vector<std::unique_ptr<LocalQueue>> local_queues;  // 每个线程的本地队列（工作窃取模式）或本地缓冲（共享队列模式）
+    std::atomic<size_t> pending{0};     // 本地队列和环形队列中尚未被取走的任务数
+    std::atomic<size_t> idle{0};        // 正在休眠的线程数，只在持有queue_mutex时修改
+    std::atomic<size_t> next_queue{0};  // 外部提交的轮询游标（工作窃取模式）
+
+    std::unique_ptr<MpmcQueue<QueuedTask>> ring;  // 有界无锁队列（有界队列模式）
+    Backpressure backpressure;                    // 队列满时的处理方式
+    std::atomic<size_t> blocked_producers{0};     // 因队列满而阻塞的提交方数
+    std::mutex space_mutex;
+    std::condition_variable space_available;      // 有空位时通知阻塞的提交方
 
     std::mutex queue_mutex;  // 任务队列的互斥锁
     std::condition_variable condition;  // 条件变量，用于线程间通信
-    bool stop;  // 线程池停止标志
+    std::atomic<bool> stop;  // 线程池停止标志
+
+    std::once_flag timers_once;
+    std::unique_ptr<TimerWheel> timers;  // 定时任务的时间轮，按需创建
+    std::atomic<uint64_t> timer_dropped{0};  // 到期后没能入队的定时任务数
+
+    // 当前线程所属的线程池及其下标，用于识别“工作线程内部的提交”
+    static inline thread_local ThreadPool* current_pool = nullptr;
+    static inline thread_local size_t current_index = 0;
+};
+
+// 结构化任务组：spawn 派生的子任务在 wait 处一起汇合。
+// 任一子任务抛出异常时记录第一个异常，并通过 std::stop_token 请求其余子任务停止：
+// 还没开始的子任务直接跳过，正在运行的子任务需要自己检查 stop_token（协作式取消）。
+// 在工作线程上调用 wait 时会顺手执行排队中的任务，而不是阻塞整个线程
+class task_group {
+public:
+    explicit task_group(ThreadPool& pool) : pool(pool), state(std::make_shared<State>()) {}
+
+    task_group(const task_group&) = delete;
+    task_group& operator=(const task_group&) = delete;
+
+    // 还有未完成的子任务时先请求停止，再等它们结束（不抛出它们的异常）
+    ~task_group() {
+        cancel();
+        wait_all();
+    }
+
+    // 派生子任务：f 可以接受一个 std::stop_token，也可以不带参数
+    template<typename F>
+        requires std::invocable<std::decay_t<F>&, std::stop_token> || std::invocable<std::decay_t<F>&>
+    void spawn(F&& f) {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            ++state->outstanding;
+        }
+        try {
+            pool.post([s = state, fn = std::forward<F>(f)]() mutable {
+                std::stop_token token = s->current_source().get_token();
+                if (!token.stop_requested()) {
+                    try {
+                        if constexpr (std::invocable<std::decay_t<F>&, std::stop_token>)
+                            fn(token);
+                        else
+                            fn();
+                    } catch (...) {
+                        s->fail(std::current_exception());
+                    }
+                }
+                s->finish();
+                });
+        } catch (...) {
+            state->finish();  // 线程池已停止，子任务没有提交出去
+            throw;
+        }
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            ++state->posted;
+        }
+        state->done.notify_all();  // 在工作线程上等待的 wait 可以回去执行它
+    }
+
+    // 等待所有子任务结束；有子任务抛出异常时重新抛出第一个。
+    // 返回后组可以继续使用（取消状态被重置）
+    void wait() {
+        wait_all();
+        std::exception_ptr error;
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            error = std::exchange(state->error, nullptr);
+            state->source = std::stop_source();
+        }
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    // 请求所有子任务停止
+    void cancel() noexcept { state->current_source().request_stop(); }
+
+    bool canceled() const noexcept { return state->current_source().stop_requested(); }
+
+    // 供子任务以外的代码（如子任务里再派生的工作）观察取消状态
+    std::stop_token stop_token() const noexcept { return state->current_source().get_token(); }
+
+private:
+    // 子任务持有shared_ptr，组对象本身被销毁前一定已等到它们全部结束
+    struct State {
+        std::stop_source source;  // wait 会重置它，读写都在 mutex 下进行
+        std::mutex mutex;
+        std::condition_variable done;
+        size_t outstanding = 0;
+        uint64_t posted = 0;      // 已提交到线程池的子任务数，等待中的工作线程据此醒来执行新任务
+        std::exception_ptr error;
+
+        // 拷贝出来的 stop_source 与组共享停止状态；request_stop 在锁外调用，
+        // 停止回调里再访问任务组也不会死锁
+        std::stop_source current_source() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return source;
+        }
+
+        void fail(std::exception_ptr e) {
+            std::stop_source s;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error)
+                    error = std::move(e);
+                s = source;
+            }
+            s.request_stop();
+        }
+
+        void finish() {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--outstanding == 0)
+                done.notify_all();
+        }
+    };
+
+    void wait_all() {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        while (state->outstanding > 0) {
+            if (!pool.on_worker_thread()) {
+                state->done.wait(lock, [this] { return state->outstanding == 0; });
+                break;
+            }
+            // 工作线程：先帮忙执行排队的任务；没有可执行的说明剩下的子任务都在别的线程上运行，
+            // 等到它们结束或者又有子任务提交进来再继续
+            const uint64_t seen = state->posted;
+            lock.unlock();
+            bool ran = pool.run_pending_here();
+            lock.lock();
+            if (!ran)
+                state->done.wait(lock, [this, seen] { return state->outstanding == 0 || state->posted != seen; });
+        }
+    }
+
+    ThreadPool& pool;
+    std::shared_ptr<State> state;
 };
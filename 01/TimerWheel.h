@@ -0,0 +1,354 @@
+#pragma once
+#include <vector>
+#include <array>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include "Task.h"
+
+// 定时器句柄：低32位是节点下标，高32位是节点的代数，节点被复用后旧句柄自动失效
+using TimerId = uint64_t;
+inline constexpr TimerId invalid_timer = 0;
+
+// 分层时间轮：4层、每层256个槽，最底层一格一个tick（默认1ms），总跨度 2^32 个tick。
+// 每个槽是一条侵入式双向链表，插入和取消都是 O(1)；
+// 推进一个tick只处理当前槽，以及每256个tick把上一层的一个槽重新分散到下层（级联）。
+// 到期的任务不在时间轮线程上执行，而是交给 dispatch（通常是投递到线程池）
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Dispatch = std::function<void(Task)>;
+
+    explicit TimerWheel(Dispatch dispatch, Clock::duration tick = std::chrono::milliseconds(1))
+        : dispatch(std::move(dispatch)), tick(tick), start(Clock::now()) {
+        heads.fill(npos);
+        thread = std::thread([this] { this->run(); });
+    }
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // 停止时间轮线程，尚未到期的定时器直接丢弃
+    ~TimerWheel() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        wakeup.notify_one();
+        thread.join();
+    }
+
+    // 在 when 时刻执行一次（精度为一个tick，不会早于 when）
+    TimerId add_at(Clock::time_point when, Task task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        catch_up_idle();
+        uint32_t n = allocate();
+        nodes[n].task = std::move(task);
+        link(n, ticks_until(when));
+        return notify_inserted(n);
+    }
+
+    // 首次在 period 之后执行，此后每隔 period 执行一次。
+    // 上一次还没执行完时跳过这一次，同一个周期任务不会并发执行
+    TimerId add_every(Clock::duration period, Task task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        catch_up_idle();
+        uint32_t n = allocate();
+        uint64_t ticks = period <= tick ? 1 : static_cast<uint64_t>(period / tick);
+        nodes[n].period = ticks;
+        nodes[n].periodic = std::make_shared<Periodic>(std::move(task));
+        link(n, ticks_until(Clock::now() + period));
+        return notify_inserted(n);
+    }
+
+    // 取消尚未到期的定时器（周期定时器取消后不再触发，已投递出去的那次仍会执行）。
+    // 定时器不存在或已经触发过时返回false
+    bool cancel(TimerId id) {
+        uint32_t n = static_cast<uint32_t>(id & 0xffffffffu);
+        uint32_t gen = static_cast<uint32_t>(id >> 32);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (n >= nodes.size() || nodes[n].generation != gen || !nodes[n].linked)
+            return false;
+        unlink(n);
+        release(n);
+        return true;
+    }
+
+    // 等待中的定时器个数
+    size_t pending() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return active;
+    }
+
+private:
+    static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+    static constexpr unsigned slot_bits = 8;
+    static constexpr size_t slots = size_t(1) << slot_bits;
+    static constexpr size_t levels = 4;
+
+    // 周期任务的可调用对象被多次投递，用shared_ptr共享，并用running标志防止重叠执行
+    struct Periodic {
+        explicit Periodic(Task fn) : fn(std::move(fn)) {}
+        Task fn;
+        std::atomic<bool> running{false};
+    };
+
+    // 每次投递出去的执行持有一个：任务正常返回、抛出异常，或者被线程池拒绝后直接销毁，
+    // 都在析构时清除running，周期任务不会因为某一次没有执行而再也不触发
+    struct RunningGuard {
+        explicit RunningGuard(std::shared_ptr<Periodic> p) : p(std::move(p)) {}
+        RunningGuard(RunningGuard&&) noexcept = default;
+        RunningGuard& operator=(RunningGuard&&) = delete;
+        ~RunningGuard() {
+            if (p)
+                p->running.store(false);
+        }
+        std::shared_ptr<Periodic> p;
+    };
+
+    struct Node {
+        uint32_t prev = npos;
+        uint32_t next = npos;
+        uint32_t slot = 0;        // 所在链表头在heads中的下标
+        uint32_t generation = 1;
+        bool linked = false;
+        uint64_t expire = 0;      // 到期的tick
+        uint64_t period = 0;      // 周期（tick），0表示一次性
+        Task task;
+        std::shared_ptr<Periodic> periodic;
+    };
+
+    uint32_t allocate() {
+        if (free_head != npos) {
+            uint32_t n = free_head;
+            free_head = nodes[n].next;
+            return n;
+        }
+        nodes.emplace_back();
+        return static_cast<uint32_t>(nodes.size() - 1);
+    }
+
+    // 节点回收到空闲链表，代数加一使旧句柄失效
+    void release(uint32_t n) {
+        Node& node = nodes[n];
+        node.task = Task();
+        node.periodic.reset();
+        node.period = 0;
+        ++node.generation;
+        if (node.generation == 0)
+            node.generation = 1;  // 保证句柄不会等于 invalid_timer
+        node.next = free_head;
+        free_head = n;
+    }
+
+    TimerId notify_inserted(uint32_t n) {
+        // 时间轮线程在没有定时器时无限期休眠，有定时器时睡到最近的事件；新定时器更早时叫醒它重新计算
+        if (active++ == 0 || nodes[n].expire < wake_tick)
+            wakeup.notify_one();
+        return (static_cast<TimerId>(nodes[n].generation) << 32) | n;
+    }
+
+    // 第n个tick的时刻，到了这个时刻才处理它
+    Clock::time_point time_of(uint64_t n) const {
+        return start + tick * static_cast<int64_t>(n);
+    }
+
+    // 没有定时器时时间轮线程不推进tick；插入前直接把tick拨到现在，免得之后逐个tick地追赶
+    void catch_up_idle() {
+        if (active != 0)
+            return;
+        uint64_t elapsed = static_cast<uint64_t>((Clock::now() - start) / tick);
+        if (elapsed > next_tick)
+            next_tick = elapsed;
+    }
+
+    // 到 now 为止已经到期的最后一个tick
+    uint64_t last_due_tick(Clock::time_point now) const {
+        if (now < start)
+            return 0;
+        return static_cast<uint64_t>((now - start) / tick);
+    }
+
+    // 从 next_tick 开始第一个需要处理的tick：最底层最近的非空槽，或者最近一次要级联出非空槽的整256个tick。
+    // 中间的tick推进时什么也不做，可以直接跳过，时间轮线程也不必每个tick醒一次
+    uint64_t next_event_tick() const {
+        uint64_t nearest = std::numeric_limits<uint64_t>::max();
+        // 最底层只放 [next_tick, next_tick+256) 内到期的定时器，扫一圈就够了
+        for (uint64_t t = next_tick; t < next_tick + slots; ++t) {
+            if (heads[t & (slots - 1)] != npos) {
+                nearest = t;
+                break;
+            }
+        }
+        // 上层的槽只在级联时才被处理，只需检查各个整256的tick；扫描的边界数有上限，超过时先醒一次再算
+        uint64_t boundary = (next_tick + slots - 1) & ~uint64_t(slots - 1);
+        for (size_t i = 0; i < slots && boundary < nearest; ++i, boundary += slots) {
+            for (size_t level = 1; level < levels; ++level) {
+                if ((boundary & ((uint64_t(1) << (slot_bits * level)) - 1)) != 0)
+                    break;
+                if (heads[level * slots + ((boundary >> (slot_bits * level)) & (slots - 1))] != npos)
+                    return boundary;
+            }
+        }
+        return nearest < boundary ? nearest : boundary;
+    }
+
+    // 时刻换算成tick，向上取整，保证不早于给定时刻
+    uint64_t ticks_until(Clock::time_point when) const {
+        if (when <= start)
+            return 0;
+        auto d = when - start;
+        return static_cast<uint64_t>((d + tick - Clock::duration(1)) / tick);
+    }
+
+    // 按距离下一个待处理tick的远近放到对应层的槽里：
+    // 第0层放 [next_tick, next_tick+256) 内到期的，第k层每个槽覆盖 256^k 个tick
+    void link(uint32_t n, uint64_t expire) {
+        Node& node = nodes[n];
+        if (expire < next_tick)
+            expire = next_tick;  // 已经过期的放到下一个tick
+        node.expire = expire;
+
+        uint64_t delta = expire - next_tick;
+        size_t level = 0;
+        while (level + 1 < levels && delta >= (uint64_t(1) << (slot_bits * (level + 1))))
+            ++level;
+        uint64_t at = expire;
+        if (level == levels - 1 && delta >= (uint64_t(1) << (slot_bits * levels)))
+            at = next_tick + (uint64_t(1) << (slot_bits * levels)) - 1;  // 超出跨度：先放在最远的槽，级联时再重新分配
+        size_t slot = level * slots + ((at >> (slot_bits * level)) & (slots - 1));
+
+        node.slot = static_cast<uint32_t>(slot);
+        node.prev = npos;
+        node.next = heads[slot];
+        if (node.next != npos)
+            nodes[node.next].prev = n;
+        heads[slot] = n;
+        node.linked = true;
+    }
+
+    void unlink(uint32_t n) {
+        Node& node = nodes[n];
+        if (node.prev != npos)
+            nodes[node.prev].next = node.next;
+        else
+            heads[node.slot] = node.next;
+        if (node.next != npos)
+            nodes[node.next].prev = node.prev;
+        node.prev = node.next = npos;
+        node.linked = false;
+        --active;
+    }
+
+    // 取下整个槽的链表，返回表头
+    uint32_t take_slot(size_t slot) {
+        uint32_t n = heads[slot];
+        heads[slot] = npos;
+        return n;
+    }
+
+    // 处理tick next_tick：必要时先把上层的槽级联下来，再收集最底层对应槽里到期的任务
+    void advance(std::vector<Task>& due) {
+        const uint64_t now_tick = next_tick;
+        for (size_t level = 1; level < levels; ++level) {
+            if ((now_tick & ((uint64_t(1) << (slot_bits * level)) - 1)) != 0)
+                break;
+            size_t slot = level * slots + ((now_tick >> (slot_bits * level)) & (slots - 1));
+            for (uint32_t n = take_slot(slot); n != npos;) {
+                uint32_t next = nodes[n].next;
+                nodes[n].linked = false;
+                --active;
+                link(n, nodes[n].expire);
+                ++active;
+                n = next;
+            }
+        }
+
+        for (uint32_t n = take_slot(now_tick & (slots - 1)); n != npos;) {
+            uint32_t next = nodes[n].next;
+            Node& node = nodes[n];
+            node.linked = false;
+            --active;
+            if (node.expire > now_tick) {
+                // 级联时放在了更早的槽里（超出跨度的定时器），重新分配
+                link(n, node.expire);
+                ++active;
+            } else if (node.period != 0) {
+                std::shared_ptr<Periodic> p = node.periodic;
+                if (!p->running.exchange(true)) {
+                    due.emplace_back([guard = RunningGuard(p)]() mutable {
+                        guard.p->fn();
+                        });
+                }
+                link(n, node.expire + node.period);  // 按计划时间累加，不随处理延迟漂移
+                ++active;
+            } else {
+                due.push_back(std::move(node.task));
+                release(n);
+            }
+            n = next;
+        }
+        next_tick = now_tick + 1;
+    }
+
+    void run() {
+        std::vector<Task> due;
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            if (stop)
+                return;
+            if (active == 0) {
+                // 没有定时器：休眠到有新定时器插入，醒来后从当前时刻继续
+                wakeup.wait(lock, [this] { return stop || active > 0; });
+                continue;
+            }
+
+            // 处理到当前时刻为止所有经过的tick（线程被延迟调度时一次追上），没有事件的tick直接跳过
+            const uint64_t last_due = last_due_tick(Clock::now());
+            while (active > 0 && next_tick <= last_due) {
+                uint64_t event = next_event_tick();
+                if (event > next_tick) {
+                    next_tick = event <= last_due ? event : last_due + 1;
+                    continue;
+                }
+                advance(due);
+            }
+
+            if (!due.empty()) {
+                lock.unlock();
+                for (Task& t : due)
+                    dispatch(std::move(t));
+                due.clear();
+                lock.lock();
+                continue;
+            }
+
+            if (active > 0) {
+                wake_tick = next_event_tick();
+                wakeup.wait_until(lock, time_of(wake_tick));
+                wake_tick = 0;
+            }
+        }
+    }
+
+    Dispatch dispatch;
+    const Clock::duration tick;
+    const Clock::time_point start;
+
+    mutable std::mutex mutex;
+    std::condition_variable wakeup;
+    std::vector<Node> nodes;
+    std::array<uint32_t, levels * slots> heads;
+    uint32_t free_head = npos;
+    uint64_t next_tick = 0; // 下一个待处理的tick
+    uint64_t wake_tick = 0; // 时间轮线程休眠到的tick，更早的插入需要叫醒它
+    size_t active = 0;      // 链表中的定时器数
+    bool stop = false;
+    std::thread thread;
+};
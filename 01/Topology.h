@@ -0,0 +1,117 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <algorithm>
+#include <thread>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// CPU/NUMA 拓扑：从 /sys/devices/system/cpu 读取在线CPU以及每个CPU所属的NUMA节点
+// 非Linux系统或读取失败时，退化为“一个节点包含 0..hardware_concurrency-1”
+struct CpuTopology {
+    std::vector<int> cpus;                // 所有在线CPU编号（升序）
+    std::vector<std::vector<int>> nodes;  // 每个NUMA节点包含的CPU编号（按节点编号升序，跳过没有CPU的节点）
+    std::vector<int> node_ids;            // nodes[k] 对应的内核节点编号（跳过无CPU节点后与下标不一定相同）
+
+    size_t node_count() const noexcept { return nodes.size(); }
+
+    // 内核节点编号在 nodes 中的下标；该节点不存在或没有CPU时返回 npos
+    static constexpr size_t npos = static_cast<size_t>(-1);
+    size_t index_of_node(int id) const noexcept {
+        auto it = std::find(node_ids.begin(), node_ids.end(), id);
+        return it == node_ids.end() ? npos : static_cast<size_t>(it - node_ids.begin());
+    }
+
+    static CpuTopology detect(const std::string& root = "/sys/devices/system/cpu") {
+        CpuTopology topo;
+        topo.cpus = parse_list(read_first_line(root + "/online"));
+
+        // 每个 cpuN 目录下有一个指向所属节点的 nodeM 链接
+        std::vector<std::pair<int, int>> cpu_node;  // (节点, CPU)
+        for (int cpu : topo.cpus) {
+            int node = 0;
+            std::error_code ec;
+            std::filesystem::directory_iterator it(root + "/cpu" + std::to_string(cpu), ec), end;
+            for (; !ec && it != end; it.increment(ec)) {
+                std::string name = it->path().filename().string();
+                if (name.size() > 4 && name.compare(0, 4, "node") == 0
+                    && std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+                    node = std::stoi(name.substr(4));
+                    break;
+                }
+            }
+            cpu_node.emplace_back(node, cpu);
+        }
+
+        if (topo.cpus.empty()) {
+            size_t n = std::max(1u, std::thread::hardware_concurrency());
+            for (size_t i = 0; i < n; ++i) {
+                topo.cpus.push_back(static_cast<int>(i));
+                cpu_node.emplace_back(0, static_cast<int>(i));
+            }
+        }
+
+        std::sort(cpu_node.begin(), cpu_node.end());
+        int current = -1;
+        for (auto [node, cpu] : cpu_node) {
+            if (node != current) {
+                topo.nodes.emplace_back();
+                topo.node_ids.push_back(node);
+                current = node;
+            }
+            topo.nodes.back().push_back(cpu);
+        }
+        return topo;
+    }
+
+    // 解析 "0-3,8,10-11" 形式的CPU列表
+    static std::vector<int> parse_list(const std::string& text) {
+        std::vector<int> result;
+        std::stringstream ss(text);
+        std::string part;
+        while (std::getline(ss, part, ',')) {
+            if (part.empty())
+                continue;
+            try {
+                size_t dash = part.find('-');
+                int first = std::stoi(part.substr(0, dash));
+                int last = dash == std::string::npos ? first : std::stoi(part.substr(dash + 1));
+                for (int c = first; c <= last; ++c)
+                    result.push_back(c);
+            } catch (const std::exception&) {
+                return {};
+            }
+        }
+        return result;
+    }
+
+    // 把当前线程绑定到给定的CPU集合；不支持或失败时返回false（绑定只是优化，失败不影响正确性）
+    static bool pin_current_thread(const std::vector<int>& cpu_set) {
+#ifdef __linux__
+        if (cpu_set.empty())
+            return false;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cpu_set)
+            if (cpu >= 0 && cpu < CPU_SETSIZE)
+                CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        (void)cpu_set;
+        return false;
+#endif
+    }
+
+private:
+    static std::string read_first_line(const std::string& path) {
+        std::ifstream in(path);
+        std::string line;
+        std::getline(in, line);
+        return line;
+    }
+};
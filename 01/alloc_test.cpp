@@ -0,0 +1,90 @@
+#include <iostream>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include "ThreadPool.h"
+
+// 统计提交路径上的堆分配次数：替换全局operator new，
+// 预热之后再提交一批小lambda，期间（包括工作线程上）不应发生任何malloc
+// 编译：g++ -std=c++20 -O2 -pthread alloc_test.cpp -o alloc_test
+
+static std::atomic<size_t> allocations{0};
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+// 提交rounds轮，每轮batch个任务并等待完成，返回期间的分配次数
+template<typename Submit>
+size_t count_allocations(ThreadPool& pool, size_t rounds, size_t batch, Submit submit) {
+    std::atomic<size_t> done{0};
+    auto run = [&](size_t n) {
+        for (size_t r = 0; r < n; ++r) {
+            done.store(0);
+            for (size_t i = 0; i < batch; ++i)
+                submit(pool, done);
+            while (done.load() != batch)
+                std::this_thread::yield();
+        }
+    };
+
+    run(rounds);  // 预热：让队列容量、内存块池和各线程的本地缓存达到稳态
+
+    // 块在哪个线程释放取决于调度时序，偶尔某个线程的本地缓存攒到新的高点，
+    // 会让池子再切一片新块。所以测量最多重复3次取最小值：
+    // 如果提交路径上真有按任务的分配，每次测量都至少有 rounds*batch 次
+    size_t best = SIZE_MAX;
+    for (int attempt = 0; attempt < 3 && best != 0; ++attempt) {
+        size_t before = allocations.load();
+        run(rounds);
+        best = std::min(best, allocations.load() - before);
+    }
+    return best;
+}
+
+int main() {
+    int failures = 0;
+    auto check = [&](const char* name, size_t count) {
+        std::cout << (count == 0 ? "[ OK ] " : "[FAIL] ") << name
+                  << ": " << count << " allocations\n";
+        if (count != 0)
+            ++failures;
+    };
+
+    for (SchedulingMode mode : { SchedulingMode::SharedQueue, SchedulingMode::WorkStealing, SchedulingMode::BoundedQueue }) {
+        const char* prefix = mode == SchedulingMode::WorkStealing ? "work-stealing "
+                           : mode == SchedulingMode::BoundedQueue ? "bounded-mpmc  " : "shared-queue  ";
+        ThreadPool pool(4, mode);
+
+        size_t post_allocs = count_allocations(pool, 50, 256, [](ThreadPool& p, std::atomic<size_t>& done) {
+            p.post([&done] { done.fetch_add(1); });
+            });
+        check((std::string(prefix) + "post").c_str(), post_allocs);
+
+        // enqueue返回的future在提交方立即get，共享状态在不同线程间分配和释放
+        size_t enqueue_allocs = count_allocations(pool, 50, 256, [](ThreadPool& p, std::atomic<size_t>& done) {
+            int value = p.enqueue([](int x) { return x * 2; }, 21).get();
+            done.fetch_add(value == 42 ? 1 : 0);
+            });
+        check((std::string(prefix) + "enqueue").c_str(), enqueue_allocs);
+    }
+
+    // 超过内联缓冲区的可调用对象退化为堆分配，这里只验证它仍能正确执行
+    {
+        ThreadPool pool(2);
+        struct Big { char payload[256] = {}; int operator()() const { return 7; } };
+        if (pool.enqueue(Big{}).get() != 7)
+            ++failures;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
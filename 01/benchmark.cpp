@@ -0,0 +1,139 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <string>
+#include <algorithm>
+#include "ThreadPool.h"
+
+// 共享队列（mutex+condvar）与工作窃取两种调度模式的吞吐对比，以及突发负载下空闲策略的延迟对比
+// 编译：g++ -std=c++20 -O2 -pthread benchmark.cpp -o threadpool_bench
+
+using Clock = std::chrono::steady_clock;
+
+const char* mode_name(SchedulingMode mode) {
+    switch (mode) {
+    case SchedulingMode::WorkStealing: return "work-stealing";
+    case SchedulingMode::BoundedQueue: return "bounded-mpmc";
+    default: return "shared-queue";
+    }
+}
+
+// 场景1：外部线程提交大量微秒级以下的空任务
+double bench_external(SchedulingMode mode, size_t threads, size_t tasks) {
+    ThreadPool pool(threads, mode);
+    std::vector<std::future<void>> results;
+    results.reserve(tasks);
+
+    auto start = Clock::now();
+    for (size_t i = 0; i < tasks; ++i)
+        results.emplace_back(pool.enqueue([] {}));
+    for (auto& r : results)
+        r.get();
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// 场景2：任务在工作线程内部继续派生子任务（递归扇出）
+// 工作窃取模式下子任务进入本地队列，不再争抢同一把锁
+double bench_nested(SchedulingMode mode, size_t threads, size_t fanout, size_t leaves) {
+    ThreadPool pool(threads, mode);
+    std::atomic<size_t> done{0};
+    std::vector<std::future<void>> roots;
+    roots.reserve(fanout);
+
+    auto start = Clock::now();
+    for (size_t i = 0; i < fanout; ++i) {
+        roots.emplace_back(pool.enqueue([&pool, &done, leaves] {
+            for (size_t j = 0; j < leaves; ++j)
+                pool.enqueue([&done] { done.fetch_add(1, std::memory_order_relaxed); });
+            }));
+    }
+    for (auto& r : roots)
+        r.get();
+    while (done.load() != fanout * leaves)
+        std::this_thread::yield();
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// 场景3：突发负载。每隔一段时间提交一小批空任务，测量从提交到开始执行的延迟。
+// 批次之间线程都闲下来了：直接休眠的线程每批都要被futex唤醒，自旋的线程可以立即接手
+struct Latency {
+    double p50_us;
+    double p99_us;
+};
+
+Latency bench_bursty(SchedulingMode mode, IdlePolicy policy, size_t threads, size_t bursts, size_t burst_size) {
+    ThreadPoolOptions options;
+    options.threads = threads;
+    options.mode = mode;
+    options.idle_policy = policy;
+    ThreadPool pool(options);
+
+    std::vector<double> samples(bursts * burst_size);
+    std::atomic<size_t> done{0};
+    for (size_t b = 0; b < bursts; ++b) {
+        for (size_t i = 0; i < burst_size; ++i) {
+            double* slot = &samples[b * burst_size + i];
+            pool.post([slot, &done, submitted = Clock::now()] {
+                *slot = std::chrono::duration<double, std::micro>(Clock::now() - submitted).count();
+                done.fetch_add(1, std::memory_order_release);
+                });
+        }
+        while (done.load(std::memory_order_acquire) != (b + 1) * burst_size)
+            std::this_thread::yield();
+        std::this_thread::sleep_for(std::chrono::microseconds(200));  // 批次间隔，线程在此期间空闲
+    }
+
+    std::sort(samples.begin(), samples.end());
+    return { samples[samples.size() / 2], samples[samples.size() * 99 / 100] };
+}
+
+int main(int argc, char* argv[]) {
+    size_t threads = std::thread::hardware_concurrency();
+    if (argc > 1)
+        threads = std::stoul(argv[1]);
+    if (threads == 0)
+        threads = 1;
+
+    const size_t tasks = 200000;
+    const size_t fanout = 64, leaves = 4000;
+
+    std::cout << "threads: " << threads << "\n";
+    std::cout << std::left << std::setw(16) << "mode"
+              << std::right << std::setw(18) << "external(Mops/s)"
+              << std::setw(18) << "nested(Mops/s)" << "\n";
+
+    for (SchedulingMode mode : { SchedulingMode::SharedQueue, SchedulingMode::WorkStealing, SchedulingMode::BoundedQueue }) {
+        double ext = bench_external(mode, threads, tasks);
+        double nested = bench_nested(mode, threads, fanout, leaves);
+        std::cout << std::left << std::setw(16) << mode_name(mode)
+                  << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(18) << tasks / ext / 1e6
+                  << std::setw(18) << fanout * leaves / nested / 1e6 << "\n";
+    }
+
+    // 自旋只有在空闲线程有自己的核时才划算；单核机器上自旋会抢走提交方的时间片
+    const size_t bursts = 2000, burst_size = 8;
+    struct NamedPolicy {
+        const char* name;
+        IdlePolicy policy;
+    };
+    const NamedPolicy policies[] = {
+        { "park", { 0, 0 } },
+        { "spin+yield", { 4000, 64 } },
+    };
+
+    std::cout << "\nbursty: " << bursts << " bursts x " << burst_size << " tasks, 200us apart\n";
+    std::cout << std::left << std::setw(16) << "mode" << std::setw(12) << "idle"
+              << std::right << std::setw(12) << "p50(us)" << std::setw(12) << "p99(us)" << "\n";
+    for (SchedulingMode mode : { SchedulingMode::SharedQueue, SchedulingMode::WorkStealing, SchedulingMode::BoundedQueue }) {
+        for (const NamedPolicy& p : policies) {
+            Latency l = bench_bursty(mode, p.policy, threads, bursts, burst_size);
+            std::cout << std::left << std::setw(16) << mode_name(mode) << std::setw(12) << p.name
+                      << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(12) << l.p50_us << std::setw(12) << l.p99_us << "\n";
+        }
+    }
+    return 0;
+}
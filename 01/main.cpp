@@ -31,6 +31,21 @@ int main()
         std::cout << "Task " << index++ << " result: " << result.get() << '\n';
     }
 
+    // 数据并行：不再为每个元素提交任务和等待future，
+    // 而是按块切分，调用线程一起参与，最后一次性汇合
+    std::vector<int> squares(1000);
+    pool.parallel_for(0, static_cast<int>(squares.size()), 64, [&](int i) {
+        squares[i] = i * i;
+        });
+    long long sum = pool.parallel_reduce(size_t(0), squares.size(), size_t(64), 0LL,
+        [&](size_t begin, size_t end, long long acc) {
+            for (size_t i = begin; i < end; ++i)
+                acc += squares[i];
+            return acc;
+        },
+        [](long long a, long long b) { return a + b; });
+    std::cout << "Sum of squares 0..999: " << sum << '\n';
+
     std::cout << std::endl;
     return 0;
 }
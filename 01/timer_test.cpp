@@ -0,0 +1,56 @@
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "ThreadPool.h"
+
+// 周期任务在某次投递被线程池拒绝后仍应继续触发：
+// 单线程有界队列（容量2，满时拒绝），注册周期任务时队列已满，前几次投递全部被丢弃；
+// 队列排空后的200ms内应当按5ms的周期正常执行
+// 编译：g++ -std=c++20 -O2 -pthread timer_test.cpp -o timer_test
+
+int main() {
+    using namespace std::chrono_literals;
+    int failures = 0;
+
+    {
+        ThreadPoolOptions options;
+        options.threads = 1;
+        options.mode = SchedulingMode::BoundedQueue;
+        options.queue_capacity = 2;
+        options.backpressure = Backpressure::Reject;
+        ThreadPool pool(options);
+
+        // 占住唯一的工作线程，再把队列填满
+        std::atomic<bool> release{false};
+        std::atomic<bool> started{false};
+        pool.post([&] {
+            started.store(true);
+            while (!release.load())
+                std::this_thread::sleep_for(1ms);
+            });
+        while (!started.load())
+            std::this_thread::yield();
+        pool.post([] {});
+        pool.post([] {});
+
+        std::atomic<int> ticks{0};
+        TimerId id = pool.schedule_every(5ms, [&] { ticks.fetch_add(1); });
+        std::this_thread::sleep_for(50ms);  // 期间的投递都被拒绝
+        release.store(true);
+        std::this_thread::sleep_for(20ms);  // 等队列排空
+
+        int before = ticks.load();
+        std::this_thread::sleep_for(200ms);
+        int after = ticks.load();
+        pool.cancel_timer(id);
+
+        std::cout << "rejected periodic: " << after - before << " ticks in 200ms\n";
+        if (after - before < 10) {
+            std::cout << "  FAILED: periodic task stopped after a rejected dispatch\n";
+            ++failures;
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -1,7 +1,25 @@
 #pragma once
+#include <algorithm>
+#include <barrier>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace mystl {
 
+    // ִвԣΪ sort / stable_sort ĵһѡ˳а汾
+    namespace execution {
+        struct sequenced_policy {};
+        struct parallel_policy {};
+        inline constexpr sequenced_policy seq{};
+        inline constexpr parallel_policy par{};
+    } // namespace execution
+
     // ȽΧǷ
     template <typename InputIt1, typename InputIt2>
     bool equal(InputIt1 first1, InputIt1 last1, InputIt2 first2) {
@@ -48,19 +66,557 @@ namespace mystl {
         }
     }
 
-    //  (򻯰)
+    namespace detail {
+
+        // ȵֱӲ
+        inline constexpr std::ptrdiff_t insertion_sort_threshold = 24;
+        // ʱþȡУnintherѡᣬȡ
+        inline constexpr std::ptrdiff_t ninther_threshold = 128;
+        // ޷֧ÿɨĿСƫ unsigned char ¼
+        inline constexpr std::ptrdiff_t partition_block = 64;
+
+        template <typename RandomIt, typename Compare>
+        void insertion_sort(RandomIt first, RandomIt last, Compare& comp) {
+            if (first == last) return;
+            for (RandomIt cur = first + 1; cur != last; ++cur) {
+                RandomIt hole = cur;
+                RandomIt prev = cur - 1;
+                if (comp(*cur, *prev)) {
+                    auto tmp = std::move(*cur);
+                    do {
+                        *hole-- = std::move(*prev);
+                    } while (hole != first && comp(tmp, *--prev));
+                    *hole = std::move(tmp);
+                }
+            }
+        }
+
+        // Ҫ *(first - 1) κԪأڲѭʡ߽
+        template <typename RandomIt, typename Compare>
+        void unguarded_insertion_sort(RandomIt first, RandomIt last, Compare& comp) {
+            if (first == last) return;
+            for (RandomIt cur = first + 1; cur != last; ++cur) {
+                RandomIt hole = cur;
+                RandomIt prev = cur - 1;
+                if (comp(*cur, *prev)) {
+                    auto tmp = std::move(*cur);
+                    do {
+                        *hole-- = std::move(*prev);
+                    } while (comp(tmp, *--prev));
+                    *hole = std::move(tmp);
+                }
+            }
+        }
+
+        // ʹ *a <= *b <= *c
+        template <typename RandomIt, typename Compare>
+        void sort3(RandomIt a, RandomIt b, RandomIt c, Compare& comp) {
+            if (comp(*b, *a)) std::iter_swap(a, b);
+            if (comp(*c, *b)) {
+                std::iter_swap(b, c);
+                if (comp(*b, *a)) std::iter_swap(a, b);
+            }
+        }
+
+        //  hole Ϊµ󶥶ѣvalue 䵽ʵλ
+        template <typename RandomIt, typename Distance, typename T, typename Compare>
+        void sift_down(RandomIt first, Distance hole, Distance len, T value, Compare& comp) {
+            Distance child;
+            while ((child = 2 * hole + 1) < len) {
+                if (child + 1 < len && comp(*(first + child), *(first + child + 1))) ++child;
+                if (!comp(value, *(first + child))) break;
+                *(first + hole) = std::move(*(first + child));
+                hole = child;
+            }
+            *(first + hole) = std::move(value);
+        }
+
+        template <typename RandomIt, typename Compare>
+        void heap_sort(RandomIt first, RandomIt last, Compare& comp) {
+            auto len = last - first;
+            for (auto i = len / 2; i-- > 0;)
+                sift_down(first, i, len, std::move(*(first + i)), comp);
+            while (--len > 0) {
+                auto value = std::move(*(first + len));
+                *(first + len) = std::move(*first);
+                sift_down(first, decltype(len)(0), len, std::move(value), comp);
+            }
+        }
+
+        //  *first ΪỮ֣λã߶Сᣬұ߶Сᡣ
+        // Ҫ first ֮вСԪأȡб֤
+        //  BlockQuicksort ʽĿ黮֣ȰһŴߵԪƫ޷֧ؼٳɶԽ
+        // ȽϽתûз֧Ԥʧ
+        template <typename RandomIt, typename Compare>
+        RandomIt partition_right(RandomIt begin, RandomIt end, Compare& comp) {
+            auto pivot = std::move(*begin);
+            RandomIt first = begin;
+            RandomIt last = end;
+
+            while (comp(*++first, pivot));
+            if (first - 1 == begin) {
+                while (first < last && !comp(*--last, pivot));
+            }
+            else {
+                while (!comp(*--last, pivot));
+            }
+
+            if (first < last) {
+                std::iter_swap(first, last);
+                ++first;
+
+                unsigned char offsets_l[partition_block];
+                unsigned char offsets_r[partition_block];
+                RandomIt base_l = first;
+                RandomIt base_r = last;
+                std::ptrdiff_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+
+                while (first < last) {
+                    // ıߵƫ˾ɨıߣʣ಻ʱָ
+                    std::ptrdiff_t unknown = last - first;
+                    std::ptrdiff_t split_l = num_l == 0 ? (num_r == 0 ? unknown / 2 : unknown) : 0;
+                    std::ptrdiff_t split_r = num_r == 0 ? unknown - split_l : 0;
+                    if (split_l > partition_block) split_l = partition_block;
+                    if (split_r > partition_block) split_r = partition_block;
+
+                    for (std::ptrdiff_t i = 0; i < split_l; ++i) {
+                        offsets_l[num_l] = static_cast<unsigned char>(i);
+                        num_l += !comp(*first, pivot);
+                        ++first;
+                    }
+                    for (std::ptrdiff_t i = 0; i < split_r; ++i) {
+                        offsets_r[num_r] = static_cast<unsigned char>(i + 1);
+                        num_r += comp(*--last, pivot);
+                    }
+
+                    std::ptrdiff_t num = num_l < num_r ? num_l : num_r;
+                    for (std::ptrdiff_t i = 0; i < num; ++i)
+                        std::iter_swap(base_l + offsets_l[start_l + i], base_r - offsets_r[start_r + i]);
+                    num_l -= num;
+                    num_r -= num;
+                    start_l += num;
+                    start_r += num;
+                    if (num_l == 0) { start_l = 0; base_l = first; }
+                    if (num_r == 0) { start_r = 0; base_r = last; }
+                }
+
+                // ɨһ߻зŴԪأǻֽ紦
+                if (num_l) {
+                    while (num_l--) std::iter_swap(base_l + offsets_l[start_l + num_l], --last);
+                    first = last;
+                }
+                if (num_r) {
+                    while (num_r--) std::iter_swap(base_r - offsets_r[start_r + num_r], first), ++first;
+                }
+            }
+
+            RandomIt pivot_pos = first - 1;
+            *begin = std::move(*pivot_pos);
+            *pivot_pos = std::move(pivot);
+            return pivot_pos;
+        }
+
+        // ԪأһᣩʱʹãѵԪȫŵߣ
+        // ֮ظֵԵġһλ
+        template <typename RandomIt, typename Compare>
+        RandomIt partition_left(RandomIt begin, RandomIt end, Compare& comp) {
+            RandomIt first = begin;
+            RandomIt last = end;
+
+            while (comp(*begin, *--last));
+            if (last + 1 == end) {
+                while (first < last && !comp(*begin, *++first));
+            }
+            else {
+                while (!comp(*begin, *++first));
+            }
+
+            while (first < last) {
+                std::iter_swap(first, last);
+                while (comp(*begin, *--last));
+                while (!comp(*begin, *++first));
+            }
+
+            std::iter_swap(begin, last);
+            return last;
+        }
+
+        template <typename RandomIt, typename Compare>
+        void introsort_loop(RandomIt first, RandomIt last, Compare& comp, int depth_limit, bool leftmost) {
+            while (true) {
+                auto size = last - first;
+                if (size <= insertion_sort_threshold) {
+                    if (leftmost) insertion_sort(first, last, comp);
+                    else unguarded_insertion_sort(first, last, comp);
+                    return;
+                }
+                // ֳ⣬ö O(n log n)
+                if (depth_limit == 0) {
+                    heap_sort(first, last, comp);
+                    return;
+                }
+                --depth_limit;
+
+                RandomIt mid = first + size / 2;
+                if (size > ninther_threshold) {
+                    sort3(first, mid, last - 1, comp);
+                    sort3(first + 1, mid - 1, last - 2, comp);
+                    sort3(first + 2, mid + 1, last - 3, comp);
+                    sort3(mid - 1, mid, mid + 1, comp);
+                    std::iter_swap(first, mid);
+                }
+                else {
+                    sort3(mid, first, last - 1, comp);
+                }
+
+                if (!leftmost && !comp(*(first - 1), *first)) {
+                    first = partition_left(first, last, comp) + 1;
+                    continue;
+                }
+
+                RandomIt cut = partition_right(first, last, comp);
+                // ݹ鴦϶̵һߣϳһѭջȲ log2(n)
+                if (cut - first < last - cut) {
+                    introsort_loop(first, cut, comp, depth_limit, leftmost);
+                    first = cut + 1;
+                    leftmost = false;
+                }
+                else {
+                    introsort_loop(cut + 1, last, comp, depth_limit, false);
+                    last = cut;
+                }
+            }
+        }
+
+    } // namespace detail
+
+    // ʡ򣩣/ȡѡᣬʽ޷֧֣С
+    // ݹȳ 2*log2(n) ʱתΪ򡣲ȶ
+    template <typename RandomIt, typename Compare>
+    void sort(RandomIt first, RandomIt last, Compare comp) {
+        auto n = last - first;
+        if (n < 2) return;
+        int depth_limit = 0;
+        for (auto i = n; i > 1; i >>= 1) depth_limit += 2;
+        detail::introsort_loop(first, last, comp, depth_limit, true);
+    }
+
     template <typename RandomIt>
     void sort(RandomIt first, RandomIt last) {
-        if (first == last) return;
+        mystl::sort(first, last, std::less<>());
+    }
+
+    template <typename RandomIt, typename Compare>
+    void sort(execution::sequenced_policy, RandomIt first, RandomIt last, Compare comp) {
+        mystl::sort(first, last, comp);
+    }
+
+    template <typename RandomIt>
+    void sort(execution::sequenced_policy, RandomIt first, RandomIt last) {
+        mystl::sort(first, last);
+    }
+
+    namespace detail {
 
-        auto pivot = *first;
-        RandomIt middle1 = std::partition(
-            first, last, [pivot](const auto& em) { return em < pivot; });
-        RandomIt middle2 = std::partition(
-            middle1, last, [pivot](const auto& em) { return !(pivot < em); });
+        // ȶȰгôĶϲ
+        inline constexpr std::ptrdiff_t stable_run = 32;
+        // а汾ÿ߳ٷֵôԪأСֱ˳
+        inline constexpr std::ptrdiff_t parallel_min_chunk = 1 << 15;
 
-        sort(first, middle1);
-        sort(middle2, last);
+        // δʼʱconstructed Ϊ true ʱǰȫԪ
+        template <typename T>
+        struct temp_buffer {
+            std::allocator<T> alloc;
+            T* data;
+            std::ptrdiff_t size;
+            bool constructed = false;
+
+            explicit temp_buffer(std::ptrdiff_t n) : data(alloc.allocate(n)), size(n) {}
+            ~temp_buffer() {
+                if (constructed) std::destroy(data, data + size);
+                alloc.deallocate(data, size);
+            }
+            temp_buffer(const temp_buffer&) = delete;
+            temp_buffer& operator=(const temp_buffer&) = delete;
+        };
+
+        // ȶϲ [a, a_end)  [b, b_end)  outʱȡ a
+        template <typename InIt, typename OutIt, typename Compare>
+        OutIt move_merge(InIt a, InIt a_end, InIt b, InIt b_end, OutIt out, Compare& comp) {
+            while (a != a_end && b != b_end) {
+                if (comp(*b, *a)) *out++ = std::move(*b++);
+                else *out++ = std::move(*a++);
+            }
+            out = std::move(a, a_end, out);
+            return std::move(b, b_end, out);
+        }
+
+        // ȶϲ AB ǰ d Ԫжٸ A merge path ϶֣
+        template <typename It, typename Compare>
+        std::ptrdiff_t merge_split(It a, std::ptrdiff_t na, It b, std::ptrdiff_t nb, std::ptrdiff_t d, Compare& comp) {
+            std::ptrdiff_t lo = d > nb ? d - nb : 0;
+            std::ptrdiff_t hi = d < na ? d : na;
+            while (lo < hi) {
+                std::ptrdiff_t i = lo + (hi - lo) / 2;
+                if (!comp(*(b + (d - i - 1)), *(a + i))) lo = i + 1;  // A[i]  B[d-i-1]Ҳǰ d 
+                else hi = i;
+            }
+            return lo;
+        }
+
+        // λ x һڶԼԶκϲǰ x - s ԪжٸΡ
+        // x ĳԵ㡢䵥һĩβʱҪз֣ 0
+        template <typename It, typename Compare>
+        std::ptrdiff_t split_at(It src, const std::vector<std::ptrdiff_t>& bounds, std::ptrdiff_t x, Compare& comp) {
+            std::size_t runs = bounds.size() - 1;
+            for (std::size_t r = 0; r + 1 < runs; r += 2) {
+                std::ptrdiff_t s = bounds[r];
+                std::ptrdiff_t m = bounds[r + 1];
+                std::ptrdiff_t e = bounds[r + 2];
+                if (x <= s) break;
+                if (x < e) return merge_split(src + s, m - s, src + m, e - m, x - s, comp);
+            }
+            return 0;
+        }
+
+        //  src а bounds ֵϲ dstֻдλ [lo, hi)
+        // a_loa_hi  split_at(lo)split_at(hi) Ľ̸߳һʱصͬ
+        // зֵκ߳̿ʼƶԪ֮ǰã߳ѾߵԪ
+        template <typename SrcIt, typename DstIt, typename Compare>
+        void merge_runs_slice(SrcIt src, DstIt dst, const std::vector<std::ptrdiff_t>& bounds,
+                              std::ptrdiff_t lo, std::ptrdiff_t hi, std::ptrdiff_t a_lo, std::ptrdiff_t a_hi,
+                              Compare& comp) {
+            std::size_t runs = bounds.size() - 1;
+            for (std::size_t r = 0; r < runs; r += 2) {
+                std::ptrdiff_t s = bounds[r];
+                std::ptrdiff_t e = r + 1 < runs ? bounds[r + 2] : bounds[r + 1];
+                if (e <= lo) continue;
+                if (s >= hi) break;
+                std::ptrdiff_t d0 = (lo > s ? lo : s) - s;
+                std::ptrdiff_t d1 = (hi < e ? hi : e) - s;
+                if (r + 1 == runs) {
+                    // 䵥һԭȥ
+                    std::move(src + s + d0, src + s + d1, dst + s + d0);
+                    continue;
+                }
+                std::ptrdiff_t m = bounds[r + 1];
+                std::ptrdiff_t a0 = lo > s ? a_lo : 0;
+                std::ptrdiff_t a1 = hi < e ? a_hi : m - s;
+                SrcIt a = src + s;
+                SrcIt b = src + m;
+                move_merge(a + a0, a + a1, b + (d0 - a0), b + (d1 - a1), dst + s + d0, comp);
+            }
+        }
+
+        // Ѿ buf С bounds ֶʱ buf  [first, ...) ֺ֮ϲ
+        // սд firstֻ߳λ [lo, hi)sync ȴ̵߳ͬһλ
+        template <typename RandomIt, typename T, typename Compare, typename Sync>
+        void merge_rounds(RandomIt first, T* buf, std::vector<std::ptrdiff_t> bounds,
+                          std::ptrdiff_t lo, std::ptrdiff_t hi, Compare& comp, Sync sync) {
+            bool in_buf = true;
+            std::vector<std::ptrdiff_t> next;
+            while (bounds.size() > 2) {
+                if (in_buf) {
+                    std::ptrdiff_t a_lo = split_at(buf, bounds, lo, comp);
+                    std::ptrdiff_t a_hi = split_at(buf, bounds, hi, comp);
+                    sync();
+                    merge_runs_slice(buf, first, bounds, lo, hi, a_lo, a_hi, comp);
+                }
+                else {
+                    std::ptrdiff_t a_lo = split_at(first, bounds, lo, comp);
+                    std::ptrdiff_t a_hi = split_at(first, bounds, hi, comp);
+                    sync();
+                    merge_runs_slice(first, buf, bounds, lo, hi, a_lo, a_hi, comp);
+                }
+                in_buf = !in_buf;
+
+                next.clear();
+                for (std::size_t i = 0; i < bounds.size(); i += 2) next.push_back(bounds[i]);
+                if (next.back() != bounds.back()) next.push_back(bounds.back());
+                bounds.swap(next);
+                sync();
+            }
+            if (in_buf) std::move(buf + lo, buf + hi, first + lo);
+        }
+
+        // ĹǼܣ䰴߳ȷ֣ÿ߳ local_sort źԼǶΣ
+        // Ȼ߳һֺϲÿÿ߳Ԫأstd::barrier ֣
+        // ߳ȡӲÿ߳ parallel_min_chunk Ԫ
+        template <typename RandomIt, typename Compare, typename LocalSort>
+        void parallel_merge_sort(RandomIt first, RandomIt last, Compare comp, LocalSort local_sort) {
+            using T = typename std::iterator_traits<RandomIt>::value_type;
+            std::ptrdiff_t n = last - first;
+            std::ptrdiff_t threads = n / parallel_min_chunk;
+            std::ptrdiff_t hw = std::thread::hardware_concurrency();
+            if (threads > hw) threads = hw;
+            if (threads < 2) {
+                local_sort(first, last, comp);
+                return;
+            }
+
+            std::vector<std::ptrdiff_t> bounds(threads + 1);
+            for (std::ptrdiff_t i = 0; i <= threads; ++i) bounds[i] = n * i / threads;
+            temp_buffer<T> buf(n);
+            std::barrier<> sync(threads);
+
+            auto work = [&](std::ptrdiff_t t) {
+                Compare c = comp;
+                std::ptrdiff_t lo = bounds[t];
+                std::ptrdiff_t hi = bounds[t + 1];
+                local_sort(first + lo, first + hi, c);
+                std::uninitialized_move(first + lo, first + hi, buf.data + lo);
+                sync.arrive_and_wait();
+                merge_rounds(first, buf.data, bounds, lo, hi, c, [&sync] { sync.arrive_and_wait(); });
+            };
+
+            std::vector<std::thread> workers;
+            workers.reserve(threads - 1);
+            for (std::ptrdiff_t t = 1; t < threads; ++t) workers.emplace_back(work, t);
+            work(0);
+            for (auto& w : workers) w.join();
+            buf.constructed = true;
+        }
+
+    } // namespace detail
+
+    // ȶÿ 32 Ԫһβٽ n ԪصʱԵֺϲ
+    template <typename RandomIt, typename Compare>
+    void stable_sort(RandomIt first, RandomIt last, Compare comp) {
+        using T = typename std::iterator_traits<RandomIt>::value_type;
+        std::ptrdiff_t n = last - first;
+        if (n <= detail::stable_run) {
+            detail::insertion_sort(first, last, comp);
+            return;
+        }
+
+        std::vector<std::ptrdiff_t> bounds;
+        for (std::ptrdiff_t s = 0; s < n; s += detail::stable_run) {
+            std::ptrdiff_t e = n - s < detail::stable_run ? n : s + detail::stable_run;
+            detail::insertion_sort(first + s, first + e, comp);
+            bounds.push_back(s);
+        }
+        bounds.push_back(n);
+
+        detail::temp_buffer<T> buf(n);
+        std::uninitialized_move(first, last, buf.data);
+        buf.constructed = true;
+        detail::merge_rounds(first, buf.data, std::move(bounds), 0, n, comp, [] {});
+    }
+
+    template <typename RandomIt>
+    void stable_sort(RandomIt first, RandomIt last) {
+        mystl::stable_sort(first, last, std::less<>());
+    }
+
+    template <typename RandomIt, typename Compare>
+    void stable_sort(execution::sequenced_policy, RandomIt first, RandomIt last, Compare comp) {
+        mystl::stable_sort(first, last, comp);
+    }
+
+    template <typename RandomIt>
+    void stable_sort(execution::sequenced_policy, RandomIt first, RandomIt last) {
+        mystl::stable_sort(first, last);
+    }
+
+    // 򣺸߳ȶԼǶʡٲֺϲ
+    //  std::execution::par һȽϺ׳쳣ʱ std::terminate
+    template <typename RandomIt, typename Compare>
+    void sort(execution::parallel_policy, RandomIt first, RandomIt last, Compare comp) {
+        detail::parallel_merge_sort(first, last, comp,
+            [](RandomIt f, RandomIt l, Compare& c) { mystl::sort(f, l, c); });
+    }
+
+    template <typename RandomIt>
+    void sort(execution::parallel_policy policy, RandomIt first, RandomIt last) {
+        mystl::sort(policy, first, last, std::less<>());
+    }
+
+    // ȶ򣺸˳ȶ򣬺ϲʱԪȡһεģȻȶ
+    template <typename RandomIt, typename Compare>
+    void stable_sort(execution::parallel_policy, RandomIt first, RandomIt last, Compare comp) {
+        detail::parallel_merge_sort(first, last, comp,
+            [](RandomIt f, RandomIt l, Compare& c) { mystl::stable_sort(f, l, c); });
+    }
+
+    template <typename RandomIt>
+    void stable_sort(execution::parallel_policy policy, RandomIt first, RandomIt last) {
+        mystl::stable_sort(policy, first, last, std::less<>());
+    }
+
+    namespace detail {
+
+        // õ޷żзתλʹǰ޷űȽϵ˳򲻱
+        template <typename K>
+        constexpr std::make_unsigned_t<K> radix_key(K k) noexcept {
+            using U = std::make_unsigned_t<K>;
+            if constexpr (std::is_signed_v<K>) return static_cast<U>(k) ^ (U(1) << (sizeof(U) * 8 - 1));
+            else return k;
+        }
+
+    } // namespace detail
+
+    // LSDֽڣkey_fn ԪӳȶO(n * sizeof())
+    // һ˱ͳƳֽڵֱͼĳֽм϶ͬʱһˣСΧļֻһˣ
+    // ԭһ n Ԫصʱ֮طַսڻʱٰԭ
+    template <typename RandomIt, typename KeyFn>
+    void radix_sort(RandomIt first, RandomIt last, KeyFn key_fn) {
+        using T = typename std::iterator_traits<RandomIt>::value_type;
+        using K = std::remove_cvref_t<std::invoke_result_t<KeyFn&, const T&>>;
+        static_assert(std::is_integral_v<K> && !std::is_same_v<K, bool>, "radix_sort key must be an integer");
+        using U = std::make_unsigned_t<K>;
+        constexpr std::size_t digits = sizeof(U);
+
+        auto key = [&key_fn](const T& x) { return detail::radix_key(std::invoke(key_fn, x)); };
+        std::ptrdiff_t n = last - first;
+        if (n <= detail::insertion_sort_threshold) {
+            auto comp = [&key](const T& a, const T& b) { return key(a) < key(b); };
+            detail::insertion_sort(first, last, comp);
+            return;
+        }
+
+        std::size_t counts[digits][256] = {};
+        for (RandomIt it = first; it != last; ++it) {
+            U k = key(*it);
+            for (std::size_t d = 0; d < digits; ++d) ++counts[d][(k >> (d * 8)) & 0xff];
+        }
+
+        detail::temp_buffer<T> buf(n);
+        bool in_buf = false;
+        U first_key = key(*first);
+        for (std::size_t d = 0; d < digits; ++d) {
+            std::size_t shift = d * 8;
+            if (counts[d][(first_key >> shift) & 0xff] == static_cast<std::size_t>(n)) continue;
+
+            std::size_t offsets[256];
+            std::size_t sum = 0;
+            for (int b = 0; b < 256; ++b) {
+                offsets[b] = sum;
+                sum += counts[d][b];
+            }
+
+            if (!in_buf) {
+                // һηַʱûйԪأ֮ǶԪظֵ
+                for (RandomIt it = first; it != last; ++it) {
+                    T* dst = buf.data + offsets[(key(*it) >> shift) & 0xff]++;
+                    if (buf.constructed) *dst = std::move(*it);
+                    else ::new (static_cast<void*>(dst)) T(std::move(*it));
+                }
+                buf.constructed = true;
+            }
+            else {
+                for (T* p = buf.data; p != buf.data + n; ++p)
+                    *(first + offsets[(key(*p) >> shift) & 0xff]++) = std::move(*p);
+            }
+            in_buf = !in_buf;
+        }
+        if (in_buf) std::move(buf.data, buf.data + n, first);
+    }
+
+    // 䰴ֵ
+    template <typename RandomIt>
+    void radix_sort(RandomIt first, RandomIt last) {
+        using T = typename std::iterator_traits<RandomIt>::value_type;
+        mystl::radix_sort(first, last, [](const T& x) { return x; });
     }
 
 } // namespace mystl
\ No newline at end of file
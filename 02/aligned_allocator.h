@@ -0,0 +1,190 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+
+
+namespace mystl {
+
+    //  Align ֽڶķĬ϶뵽 64 ֽڣУҲ AVX-512 һμصĿȣ
+    //  mystl::vector ͼеҪ SIMD صĻ
+    //     mystl::vector<float, mystl::aligned_allocator<float, 32>> row(width);
+    template <typename T, std::size_t Align = 64>
+    class aligned_allocator {
+        static_assert((Align & (Align - 1)) == 0, "Align must be a power of two");
+
+    public:
+        // Ͷ
+        using value_type = T;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using reference = T&;
+        using const_reference = const T&;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+
+        using is_always_equal = std::true_type;
+
+        // ʵʹõĶ룺С T ĶҪ
+        static constexpr std::size_t alignment = Align > alignof(T) ? Align : alignof(T);
+
+        // ģзͲallocator_traits ޷ԶƵذ󶨺
+        template <typename U>
+        struct rebind {
+            using other = aligned_allocator<U, Align>;
+        };
+
+        aligned_allocator() noexcept = default;
+
+        template <typename U>
+        aligned_allocator(const aligned_allocator<U, Align>&) noexcept {}
+
+        // ڴ
+        [[nodiscard]] pointer allocate(size_type n) {
+            if (n > max_size()) {
+                throw std::bad_alloc();
+            }
+            return static_cast<pointer>(::operator new(n * sizeof(T), std::align_val_t(alignment)));
+        }
+
+        // ͷڴ
+        void deallocate(pointer p, size_type) noexcept {
+            ::operator delete(p, std::align_val_t(alignment));
+        }
+
+        // 
+        template <typename U, typename... Args>
+        void construct(U* p, Args&&... args) {
+            ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+        }
+
+        // ٶ
+        template <typename U>
+        void destroy(U* p) {
+            p->~U();
+        }
+
+        // ܷĴС
+        [[nodiscard]] size_type max_size() const noexcept {
+            return size_type(-1) / sizeof(T);
+        }
+    };
+
+    // ȽǷ
+    template <typename T1, std::size_t A1, typename T2, std::size_t A2>
+    bool operator==(const aligned_allocator<T1, A1>&, const aligned_allocator<T2, A2>&) noexcept {
+        return A1 == A2;
+    }
+
+    // 󻺳 4K ͼ֡༸ʮ MB 顣
+    // С 2MB ķ Linux ֱ mmapʼַ뵽 2MB madvise(MADV_HUGEPAGE) ͸ҳ
+    // һ 2MB ҳֻռһ TLB ˳Ϳɨʱ TLB ȱʧ١ں˲ֻ֧ر͸ҳʱ madvise ʧܣ
+    // ڴճ 4KB ҳʹãӰȷԡСķԼƽ̨˻ذж operator new
+    template <typename T>
+    class huge_page_allocator {
+    public:
+        // Ͷ
+        using value_type = T;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using reference = T&;
+        using const_reference = const T&;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+
+        using is_always_equal = std::true_type;
+
+        static constexpr std::size_t huge_page_size = std::size_t(2) << 20;
+        static constexpr std::size_t small_alignment = alignof(T) > 64 ? alignof(T) : 64;
+
+        huge_page_allocator() noexcept = default;
+
+        template <typename U>
+        huge_page_allocator(const huge_page_allocator<U>&) noexcept {}
+
+        // ڴ
+        [[nodiscard]] pointer allocate(size_type n) {
+            if (n > max_size()) {
+                throw std::bad_alloc();
+            }
+            std::size_t bytes = n * sizeof(T);
+#if defined(__linux__)
+            if (bytes >= huge_page_size) {
+                return static_cast<pointer>(map_huge(bytes));
+            }
+#endif
+            return static_cast<pointer>(::operator new(bytes, std::align_val_t(small_alignment)));
+        }
+
+        // ͷڴ棬n ʱͬݴжڴ mmap  operator new
+        void deallocate(pointer p, size_type n) noexcept {
+            std::size_t bytes = n * sizeof(T);
+#if defined(__linux__)
+            if (bytes >= huge_page_size) {
+                ::munmap(p, round_up(bytes));
+                return;
+            }
+#endif
+            ::operator delete(p, std::align_val_t(small_alignment));
+        }
+
+        // 
+        template <typename U, typename... Args>
+        void construct(U* p, Args&&... args) {
+            ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+        }
+
+        // ٶ
+        template <typename U>
+        void destroy(U* p) {
+            p->~U();
+        }
+
+        // ܷĴС
+        [[nodiscard]] size_type max_size() const noexcept {
+            return (size_type(-1) - huge_page_size) / sizeof(T);
+        }
+
+    private:
+        static std::size_t round_up(std::size_t bytes) noexcept {
+            return (bytes + huge_page_size - 1) & ~(huge_page_size - 1);
+        }
+
+#if defined(__linux__)
+        // mmap صĵַֻ 4KB 룬ӳ 2MB ٰβĲ munmap ֤ζɴҳ֧
+        static void* map_huge(std::size_t bytes) {
+            std::size_t size = round_up(bytes);
+            void* raw = ::mmap(nullptr, size + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            char* begin = static_cast<char*>(raw);
+            char* aligned = reinterpret_cast<char*>(round_up(reinterpret_cast<std::size_t>(begin)));
+            if (aligned != begin) {
+                ::munmap(begin, aligned - begin);
+            }
+            char* end = begin + size + huge_page_size;
+            if (aligned + size != end) {
+                ::munmap(aligned + size, end - (aligned + size));
+            }
+#if defined(MADV_HUGEPAGE)
+            ::madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+            return aligned;
+        }
+#endif
+    };
+
+    // ȽǷ
+    template <typename T1, typename T2>
+    bool operator==(const huge_page_allocator<T1>&, const huge_page_allocator<T2>&) noexcept {
+        return true;
+    }
+
+} // namespace mystl
\ No newline at end of file
@@ -1,12 +1,24 @@
 #pragma once
 #include <memory>
+#include <atomic>
+#include <cstddef>
 #include <cstdlib>
+#include <mutex>
 #include <new>
+#include <type_traits>
 
 
 
 namespace mystl {
 
+    // ƽضλ԰ֽڰᵽµַᶯɵַϵĶΪڣƶ
+    // ĬֻϿƽƵͣstd::unique_ptr ʵҲͿػΪ true
+    template <typename T>
+    struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+    template <typename T>
+    inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
     // 򵥵ڴʵ
     template <typename T>
     class allocator {
@@ -48,6 +60,19 @@ namespace mystl {
             std::free(p);
         }
 
+        //  allocate õ old_n ԪصĿΪ new_n Ԫأݰֽڱ
+        // ײ reallocппռʱԭչ libc ᵽµַʱͨӳҳ棬ƣ
+        // ֻڿƽضλ
+        [[nodiscard]] pointer reallocate(pointer p, size_type /*old_n*/, size_type new_n) {
+            if (new_n > max_size()) {
+                throw std::bad_alloc();
+            }
+            if (auto q = static_cast<pointer>(std::realloc(p, new_n * sizeof(T)))) {
+                return q;
+            }
+            throw std::bad_alloc();
+        }
+
         // 
         template <typename U, typename... Args>
         void construct(U* p, Args&&... args) {
@@ -72,4 +97,525 @@ namespace mystl {
         return true;
     }
 
+
+    // ---------------- ̬ڴԴ std::pmr Ӧ ----------------
+    // ķ͹̶Ϊ polymorphic_allocatorȡڴʱ memory_resource 
+    // ÷Ǵһһ֡ͼʱʱŵһ monotonic_buffer_resource ϣһͷţ
+    //     mystl::monotonic_buffer_resource arena(buf, sizeof(buf));
+    //     mystl::vector<int, mystl::polymorphic_allocator<int>> v(&arena);
+    //     ...
+    //     arena.release();   // v Ҫ
+
+    // ڴԴĳࣺе allocate/deallocate תʵֵ˽麯
+    class memory_resource {
+    public:
+        static constexpr std::size_t max_align = alignof(std::max_align_t);
+
+        virtual ~memory_resource() = default;
+
+        [[nodiscard]] void* allocate(std::size_t bytes, std::size_t alignment = max_align) {
+            return do_allocate(bytes, alignment);
+        }
+
+        void deallocate(void* p, std::size_t bytes, std::size_t alignment = max_align) {
+            do_deallocate(p, bytes, alignment);
+        }
+
+        // һԴڴܷһԴͷ
+        bool is_equal(const memory_resource& other) const noexcept {
+            return do_is_equal(other);
+        }
+
+    private:
+        virtual void* do_allocate(std::size_t bytes, std::size_t alignment) = 0;
+        virtual void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) = 0;
+        virtual bool do_is_equal(const memory_resource& other) const noexcept = 0;
+    };
+
+    inline bool operator==(const memory_resource& a, const memory_resource& b) noexcept {
+        return &a == &b || a.is_equal(b);
+    }
+
+    namespace detail {
+
+        // ֱʹô operator new/delete
+        class new_delete_resource_impl : public memory_resource {
+        private:
+            void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+                return ::operator new(bytes, std::align_val_t(alignment));
+            }
+
+            void do_deallocate(void* p, std::size_t, std::size_t alignment) override {
+                ::operator delete(p, std::align_val_t(alignment));
+            }
+
+            bool do_is_equal(const memory_resource& other) const noexcept override {
+                return this == &other;
+            }
+        };
+
+        // κη׳ bad_allocʱԱֻ֤ʹóʼ
+        class null_memory_resource_impl : public memory_resource {
+        private:
+            void* do_allocate(std::size_t, std::size_t) override {
+                throw std::bad_alloc();
+            }
+
+            void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+            bool do_is_equal(const memory_resource& other) const noexcept override {
+                return this == &other;
+            }
+        };
+
+        // ȫԴӲ̬ʱȻ԰ȫͨͷڴ
+        inline memory_resource* new_delete_resource_instance() noexcept {
+            static memory_resource* r = new new_delete_resource_impl;
+            return r;
+        }
+
+        inline std::atomic<memory_resource*>& default_resource_slot() noexcept {
+            static std::atomic<memory_resource*> slot(new_delete_resource_instance());
+            return slot;
+        }
+
+        // ڵ n С 2 
+        inline std::size_t ceil_pow2(std::size_t n) noexcept {
+            std::size_t p = 1;
+            while (p < n) {
+                p <<= 1;
+            }
+            return p;
+        }
+
+    } // namespace detail
+
+    inline memory_resource* new_delete_resource() noexcept {
+        return detail::new_delete_resource_instance();
+    }
+
+    inline memory_resource* null_memory_resource() noexcept {
+        static memory_resource* r = new detail::null_memory_resource_impl;
+        return r;
+    }
+
+    // ĬԴĬϹ polymorphic_allocator ͸ԴĬΡָʱָΪ new_delete_resourceԭԴ
+    inline memory_resource* set_default_resource(memory_resource* r) noexcept {
+        return detail::default_resource_slot().exchange(r ? r : new_delete_resource());
+    }
+
+    inline memory_resource* get_default_resource() noexcept {
+        return detail::default_resource_slot().load();
+    }
+
+    // Դڵǰ˳з֣deallocate ʲôҲڴֻ release() ʱ黹
+    // õ÷ṩĻջϵ飩¿飬ÿһ 2 
+    // ֻƶһָ룬ʺͬһʱ󣻲̰߳ȫ
+    class monotonic_buffer_resource : public memory_resource {
+    public:
+        explicit monotonic_buffer_resource(memory_resource* upstream = get_default_resource()) noexcept
+            : monotonic_buffer_resource(nullptr, 0, default_chunk_size, upstream) {}
+
+        explicit monotonic_buffer_resource(std::size_t initial_size, memory_resource* upstream = get_default_resource()) noexcept
+            : monotonic_buffer_resource(nullptr, 0, initial_size > 0 ? initial_size : 1, upstream) {}
+
+        monotonic_buffer_resource(void* buffer, std::size_t size, memory_resource* upstream = get_default_resource()) noexcept
+            : monotonic_buffer_resource(buffer, size, size > 0 ? size * 2 : default_chunk_size, upstream) {}
+
+        monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+        monotonic_buffer_resource& operator=(const monotonic_buffer_resource&) = delete;
+
+        ~monotonic_buffer_resource() override {
+            release();
+        }
+
+        // Ŀȫ黹صʱ״̬ʼͷʼã
+        void release() noexcept {
+            while (chunks_) {
+                chunk* next = chunks_->next;
+                upstream_->deallocate(chunks_, sizeof(chunk) + chunks_->size, alignof(chunk));
+                chunks_ = next;
+            }
+            current_ = static_cast<char*>(buffer_);
+            space_ = buffer_size_;
+            next_size_ = first_chunk_size_;
+        }
+
+        memory_resource* upstream_resource() const noexcept {
+            return upstream_;
+        }
+
+    private:
+        static constexpr std::size_t default_chunk_size = 1024;
+
+        // ͷÿĿͷ¼Ϳֽ
+        struct alignas(std::max_align_t) chunk {
+            chunk* next;
+            std::size_t size;
+        };
+
+        monotonic_buffer_resource(void* buffer, std::size_t size, std::size_t first_chunk, memory_resource* upstream) noexcept
+            : upstream_(upstream), buffer_(buffer), buffer_size_(size), first_chunk_size_(first_chunk),
+            current_(static_cast<char*>(buffer)), space_(size), next_size_(first_chunk), chunks_(nullptr) {}
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+            void* p = current_;
+            if (!std::align(alignment, bytes, p, space_)) {
+                // ¿Ҫŵ϶Ŀ϶
+                std::size_t size = next_size_ > bytes + alignment ? next_size_ : bytes + alignment;
+                chunk* c = static_cast<chunk*>(upstream_->allocate(sizeof(chunk) + size, alignof(chunk)));
+                c->next = chunks_;
+                c->size = size;
+                chunks_ = c;
+                current_ = reinterpret_cast<char*>(c + 1);
+                space_ = size;
+                next_size_ = size * 2;
+                p = current_;
+                std::align(alignment, bytes, p, space_);
+            }
+            current_ = static_cast<char*>(p) + bytes;
+            space_ -= bytes;
+            return p;
+        }
+
+        void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+        bool do_is_equal(const memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+        memory_resource* upstream_;
+        void* buffer_;                  // ÷ṩĳʼΪ
+        std::size_t buffer_size_;
+        std::size_t first_chunk_size_;  // release() ֮һĴС
+        char* current_;                 // ǰһֽ
+        std::size_t space_;             // ǰʣֽ
+        std::size_t next_size_;
+        chunk* chunks_;
+    };
+
+    // ԴĲ0 ʾʹĬֵ
+    struct pool_options {
+        std::size_t max_blocks_per_chunk = 0;           // һĿгٸڴ
+        std::size_t largest_required_pool_block = 0;    // С󲻽أֱӽ
+    };
+
+    // ͬԴ 2 ݷֳɴС8 ֽ𣩣ÿһͷŵڴصϸá
+    // ÿĿ鰴 2 ֱ max_blocks_per_chunk largest_required_pool_block
+    // Ҫ󳬹 max_align_t ֱתΣͬ¼release() ʱͳһ黹̰߳ȫ
+    class unsynchronized_pool_resource : public memory_resource {
+    public:
+        unsynchronized_pool_resource() : unsynchronized_pool_resource(pool_options(), get_default_resource()) {}
+
+        explicit unsynchronized_pool_resource(memory_resource* upstream)
+            : unsynchronized_pool_resource(pool_options(), upstream) {}
+
+        explicit unsynchronized_pool_resource(const pool_options& opts, memory_resource* upstream = get_default_resource())
+            : upstream_(upstream), options_(opts), pool_count_(0), large_(nullptr) {
+            if (options_.max_blocks_per_chunk == 0 || options_.max_blocks_per_chunk > max_blocks_limit) {
+                options_.max_blocks_per_chunk = options_.max_blocks_per_chunk == 0 ? default_max_blocks : max_blocks_limit;
+            }
+            std::size_t largest = options_.largest_required_pool_block == 0 ? default_largest_block : options_.largest_required_pool_block;
+            largest = detail::ceil_pow2(largest < min_block ? min_block : largest > largest_block_limit ? largest_block_limit : largest);
+            options_.largest_required_pool_block = largest;
+            for (std::size_t size = min_block; size <= largest; size <<= 1) {
+                pools_[pool_count_++] = pool{ nullptr, nullptr, 0 };
+            }
+        }
+
+        unsynchronized_pool_resource(const unsynchronized_pool_resource&) = delete;
+        unsynchronized_pool_resource& operator=(const unsynchronized_pool_resource&) = delete;
+
+        ~unsynchronized_pool_resource() override {
+            release();
+        }
+
+        // ڴȫ黹û deallocate 
+        void release() noexcept {
+            for (std::size_t i = 0; i < pool_count_; ++i) {
+                pool& pl = pools_[i];
+                while (pl.chunks) {
+                    chunk* next = pl.chunks->next;
+                    upstream_->deallocate(pl.chunks, sizeof(chunk) + pl.chunks->blocks * block_size(i), alignof(chunk));
+                    pl.chunks = next;
+                }
+                pl = pool{ nullptr, nullptr, 0 };
+            }
+            while (large_) {
+                large_block* next = large_->next;
+                upstream_->deallocate(large_base(large_), large_->total, large_->alignment);
+                large_ = next;
+            }
+        }
+
+        memory_resource* upstream_resource() const noexcept {
+            return upstream_;
+        }
+
+        pool_options options() const noexcept {
+            return options_;
+        }
+
+    private:
+        static constexpr std::size_t min_block = 8;
+        static constexpr std::size_t default_largest_block = 4096;
+        static constexpr std::size_t largest_block_limit = std::size_t(1) << 20;
+        static constexpr std::size_t default_max_blocks = 1024;
+        static constexpr std::size_t max_blocks_limit = std::size_t(1) << 16;
+        static constexpr std::size_t first_chunk_blocks = 16;
+        static constexpr std::size_t max_pools = 18;    // 8 ֽڵ 1MB
+
+        struct free_block {
+            free_block* next;
+        };
+
+        // ͷڿͷ blocks ڴ飻ͷ max_align_t 룬ڴҲٰ min(С, max_align_t) 
+        struct alignas(std::max_align_t) chunk {
+            chunk* next;
+            std::size_t blocks;
+        };
+
+        struct pool {
+            free_block* free;
+            chunk* chunks;
+            std::size_t next_blocks;    // һĿгٸڴ
+        };
+
+        // صĴ飬¼ڴǰ棬˫Ա deallocate ʱ O(1) ժ
+        struct large_block {
+            large_block* prev;
+            large_block* next;
+            std::size_t total;          // ֽ
+            std::size_t alignment;
+            std::size_t offset;         // ڴ뵽ʼַƫ
+        };
+
+        static std::size_t block_size(std::size_t index) noexcept {
+            return min_block << index;
+        }
+
+        static void* large_base(large_block* b) noexcept {
+            return reinterpret_cast<char*>(b + 1) - b->offset;
+        }
+
+        // Ӧļ𣬲ʱ pool_count_
+        std::size_t pool_index(std::size_t bytes, std::size_t alignment) const noexcept {
+            if (alignment > max_align || bytes > options_.largest_required_pool_block) {
+                return pool_count_;
+            }
+            std::size_t size = bytes > alignment ? bytes : alignment;
+            std::size_t index = 0;
+            while (block_size(index) < size) {
+                ++index;
+            }
+            return index;
+        }
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+            std::size_t index = pool_index(bytes, alignment);
+            if (index == pool_count_) {
+                return allocate_large(bytes, alignment);
+            }
+            pool& pl = pools_[index];
+            if (!pl.free) {
+                refill(pl, block_size(index));
+            }
+            free_block* b = pl.free;
+            pl.free = b->next;
+            return b;
+        }
+
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+            if (!p) {
+                return;
+            }
+            std::size_t index = pool_index(bytes, alignment);
+            if (index == pool_count_) {
+                deallocate_large(p);
+                return;
+            }
+            free_block* b = static_cast<free_block*>(p);
+            b->next = pools_[index].free;
+            pools_[index].free = b;
+        }
+
+        bool do_is_equal(const memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+        // һ飬ȫгڴҵ
+        void refill(pool& pl, std::size_t size) {
+            std::size_t blocks = pl.next_blocks == 0 ? first_chunk_blocks : pl.next_blocks;
+            if (blocks > options_.max_blocks_per_chunk) {
+                blocks = options_.max_blocks_per_chunk;
+            }
+            chunk* c = static_cast<chunk*>(upstream_->allocate(sizeof(chunk) + blocks * size, alignof(chunk)));
+            c->next = pl.chunks;
+            c->blocks = blocks;
+            pl.chunks = c;
+            pl.next_blocks = blocks * 2;
+            char* first = reinterpret_cast<char*>(c + 1);
+            for (std::size_t i = blocks; i-- > 0;) {
+                free_block* b = reinterpret_cast<free_block*>(first + i * size);
+                b->next = pl.free;
+                pl.free = b;
+            }
+        }
+
+        void* allocate_large(std::size_t bytes, std::size_t alignment) {
+            std::size_t align = alignment > alignof(large_block) ? alignment : alignof(large_block);
+            // ¼ڴǰ棬ƫȡֵڴ鱾Ȼ
+            std::size_t offset = (sizeof(large_block) + align - 1) / align * align;
+            char* base = static_cast<char*>(upstream_->allocate(offset + bytes, align));
+            large_block* b = reinterpret_cast<large_block*>(base + offset) - 1;
+            b->prev = nullptr;
+            b->next = large_;
+            b->total = offset + bytes;
+            b->alignment = align;
+            b->offset = offset;
+            if (large_) {
+                large_->prev = b;
+            }
+            large_ = b;
+            return base + offset;
+        }
+
+        void deallocate_large(void* p) {
+            large_block* b = static_cast<large_block*>(p) - 1;
+            if (b->prev) {
+                b->prev->next = b->next;
+            }
+            else {
+                large_ = b->next;
+            }
+            if (b->next) {
+                b->next->prev = b->prev;
+            }
+            upstream_->deallocate(large_base(b), b->total, b->alignment);
+        }
+
+        memory_resource* upstream_;
+        pool_options options_;
+        pool pools_[max_pools];
+        std::size_t pool_count_;
+        large_block* large_;
+    };
+
+    // ͬԴunsynchronized_pool_resource һѻԱ̹߳
+    class synchronized_pool_resource : public memory_resource {
+    public:
+        synchronized_pool_resource() : pool_() {}
+
+        explicit synchronized_pool_resource(memory_resource* upstream) : pool_(upstream) {}
+
+        explicit synchronized_pool_resource(const pool_options& opts, memory_resource* upstream = get_default_resource())
+            : pool_(opts, upstream) {}
+
+        synchronized_pool_resource(const synchronized_pool_resource&) = delete;
+        synchronized_pool_resource& operator=(const synchronized_pool_resource&) = delete;
+
+        void release() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pool_.release();
+        }
+
+        memory_resource* upstream_resource() const noexcept {
+            return pool_.upstream_resource();
+        }
+
+        pool_options options() const noexcept {
+            return pool_.options();
+        }
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return pool_.allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pool_.deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+        std::mutex mutex_;
+        unsynchronized_pool_resource pool_;
+    };
+
+    // ̬ѷתʱ memory_resourceĬ get_default_resource()
+    // mystl ƶʱͬһתƣﱣ˸ֵstd::pmr 汾ɾ
+    // ʱ׼ĬԴǶ׵ԶʹԴҪԼ
+    template <typename T = std::byte>
+    class polymorphic_allocator {
+    public:
+        // Ͷ
+        using value_type = T;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using reference = T&;
+        using const_reference = const T&;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+
+        polymorphic_allocator() noexcept : resource_(get_default_resource()) {}
+
+        polymorphic_allocator(memory_resource* r) noexcept : resource_(r) {}
+
+        template <typename U>
+        polymorphic_allocator(const polymorphic_allocator<U>& other) noexcept : resource_(other.resource()) {}
+
+        // ڴ
+        [[nodiscard]] pointer allocate(size_type n) {
+            if (n > max_size()) {
+                throw std::bad_alloc();
+            }
+            return static_cast<pointer>(resource_->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        // ͷڴ档һʱͷſָ루Ϊ0ԴͨҽֱӺ
+        void deallocate(pointer p, size_type n) noexcept {
+            if (p) {
+                resource_->deallocate(p, n * sizeof(T), alignof(T));
+            }
+        }
+
+        // 
+        template <typename U, typename... Args>
+        void construct(U* p, Args&&... args) {
+            ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+        }
+
+        // ٶ
+        template <typename U>
+        void destroy(U* p) {
+            p->~U();
+        }
+
+        // ܷĴС
+        [[nodiscard]] size_type max_size() const noexcept {
+            return size_type(-1) / sizeof(T);
+        }
+
+        polymorphic_allocator select_on_container_copy_construction() const noexcept {
+            return polymorphic_allocator();
+        }
+
+        memory_resource* resource() const noexcept {
+            return resource_;
+        }
+
+    private:
+        memory_resource* resource_;
+    };
+
+    // ʹͬһȼ۵ģԴʱ
+    template <typename T1, typename T2>
+    bool operator==(const polymorphic_allocator<T1>& a, const polymorphic_allocator<T2>& b) noexcept {
+        return *a.resource() == *b.resource();
+    }
+
 } // namespace mystl
\ No newline at end of file
@@ -0,0 +1,181 @@
+#pragma once
+#include "hash_table.h"
+#include <cstring>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+
+namespace mystl {
+
+    namespace detail {
+
+        // ӳĲλһ壺 std::pair<const K, V>ݰʱֵͨͬ std::pair<K, V>
+        // ƶstd::string  rehash ʱᱻ
+        template <typename K, typename V>
+        struct map_policy {
+            using key_type = K;
+            using mapped_type = V;
+            using value_type = std::pair<const K, V>;
+
+            union slot_type {
+                value_type value;
+                std::pair<K, V> mutable_value;
+
+                slot_type() {}
+                ~slot_type() {}
+            };
+
+            static constexpr bool constant_iterators = false;
+
+            static value_type& element(slot_type* slot) noexcept {
+                return slot->value;
+            }
+
+            static const key_type& key(const value_type& value) noexcept {
+                return value.first;
+            }
+
+            static bool equal_value(const value_type& a, const value_type& b) {
+                return a.second == b.second;
+            }
+
+            template <typename A, typename... Args>
+            static void construct(A& alloc, slot_type* slot, Args&&... args) {
+                alloc.construct(&slot->value, std::forward<Args>(args)...);
+            }
+
+            template <typename A>
+            static void destroy(A& alloc, slot_type* slot) noexcept {
+                alloc.destroy(&slot->value);
+            }
+
+            template <typename A>
+            static void transfer(A& alloc, slot_type* dst, slot_type* src) {
+                if constexpr (is_trivially_relocatable_v<K> && is_trivially_relocatable_v<V>) {
+                    std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), sizeof(slot_type));
+                }
+                else {
+                    alloc.construct(&dst->mutable_value, std::move(src->mutable_value));
+                    alloc.destroy(&src->mutable_value);
+                }
+            }
+        };
+
+    } // namespace detail
+
+    // ѰַĹϣӳ䣨SwissTable ṹӿ std::unordered_map ͬ
+    // ֵԴĲλݡrehash  reserve ʹԪصĵַʧЧ
+    // ɾԪزʹԪصĵʧЧַΪʱ findcontainseraseatoperator[]try_emplace
+    // ֱӽ std::string_view / const char*ֻʱŹ std::string
+    template <typename K, typename V, typename Hash = hash<K>, typename Eq = equal_to<K>,
+              typename Alloc = allocator<std::pair<const K, V>>>
+    class flat_hash_map : public detail::raw_hash_set<detail::map_policy<K, V>, Hash, Eq, Alloc> {
+        using base = detail::raw_hash_set<detail::map_policy<K, V>, Hash, Eq, Alloc>;
+
+        template <typename K2>
+        using key_arg = typename base::template key_arg<K2>;
+
+    public:
+        using key_type = K;
+        using mapped_type = V;
+        using typename base::value_type;
+        using typename base::iterator;
+        using typename base::const_iterator;
+        using typename base::size_type;
+
+        using base::base;
+        using base::operator=;
+
+        flat_hash_map() = default;
+
+        // Ԫط
+        template <typename K2 = key_type>
+        mapped_type& at(const key_arg<K2>& key) {
+            auto it = this->find(key);
+            if (it == this->end()) {
+                throw std::out_of_range("flat_hash_map::at");
+            }
+            return it->second;
+        }
+
+        template <typename K2 = key_type>
+        const mapped_type& at(const key_arg<K2>& key) const {
+            auto it = this->find(key);
+            if (it == this->end()) {
+                throw std::out_of_range("flat_hash_map::at");
+            }
+            return it->second;
+        }
+
+        mapped_type& operator[](key_type&& key) {
+            return try_emplace(std::move(key)).first->second;
+        }
+
+        template <typename K2 = key_type>
+        mapped_type& operator[](const key_arg<K2>& key) {
+            return try_emplace(key).first->second;
+        }
+
+        // ޸
+        // ʱ args ֵѴʱ args ᱻ
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+            return try_emplace_impl(std::move(key), std::forward<Args>(args)...);
+        }
+
+        template <typename K2 = key_type, typename... Args>
+        std::pair<iterator, bool> try_emplace(const key_arg<K2>& key, Args&&... args) {
+            return try_emplace_impl(key, std::forward<Args>(args)...);
+        }
+
+        // ʱ std::pair<K, V>  value_typeƶλظ
+        template <typename... Args>
+        std::pair<iterator, bool> emplace(Args&&... args) {
+            std::pair<K, V> tmp(std::forward<Args>(args)...);
+            return try_emplace_impl(std::move(tmp.first), std::move(tmp.second));
+        }
+
+        template <typename... Args>
+        iterator emplace_hint(const_iterator, Args&&... args) {
+            return emplace(std::forward<Args>(args)...).first;
+        }
+
+        template <typename M>
+        std::pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj) {
+            return insert_or_assign_impl(std::move(key), std::forward<M>(obj));
+        }
+
+        template <typename K2 = key_type, typename M>
+        std::pair<iterator, bool> insert_or_assign(const key_arg<K2>& key, M&& obj) {
+            return insert_or_assign_impl(key, std::forward<M>(obj));
+        }
+
+    private:
+        template <typename K2, typename... Args>
+        std::pair<iterator, bool> try_emplace_impl(K2&& key, Args&&... args) {
+            auto [index, inserted] = this->find_or_prepare_insert(key);
+            if (inserted) {
+                try {
+                    detail::map_policy<K, V>::construct(this->slot_alloc(), this->slot_at(index), std::piecewise_construct,
+                        std::forward_as_tuple(std::forward<K2>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+                }
+                catch (...) {
+                    this->abandon_slot(index);
+                    throw;
+                }
+            }
+            return { this->iterator_at(index), inserted };
+        }
+
+        template <typename K2, typename M>
+        std::pair<iterator, bool> insert_or_assign_impl(K2&& key, M&& obj) {
+            auto result = try_emplace_impl(std::forward<K2>(key), std::forward<M>(obj));
+            if (!result.second) {
+                result.first->second = std::forward<M>(obj);
+            }
+            return result;
+        }
+    };
+
+} // namespace mystl
\ No newline at end of file
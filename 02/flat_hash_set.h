@@ -0,0 +1,71 @@
+#pragma once
+#include "hash_table.h"
+#include <cstring>
+#include <utility>
+
+
+namespace mystl {
+
+    namespace detail {
+
+        // ϵĲλֱӴԪأԪرǼ
+        template <typename T>
+        struct set_policy {
+            using key_type = T;
+            using value_type = T;
+            using slot_type = T;
+
+            static constexpr bool constant_iterators = true;
+
+            static value_type& element(slot_type* slot) noexcept {
+                return *slot;
+            }
+
+            static const key_type& key(const value_type& value) noexcept {
+                return value;
+            }
+
+            static bool equal_value(const value_type&, const value_type&) noexcept {
+                return true;
+            }
+
+            template <typename A, typename... Args>
+            static void construct(A& alloc, slot_type* slot, Args&&... args) {
+                alloc.construct(slot, std::forward<Args>(args)...);
+            }
+
+            template <typename A>
+            static void destroy(A& alloc, slot_type* slot) noexcept {
+                alloc.destroy(slot);
+            }
+
+            // ʱԪشӾɲλᵽ²λ
+            template <typename A>
+            static void transfer(A& alloc, slot_type* dst, slot_type* src) {
+                if constexpr (is_trivially_relocatable_v<T>) {
+                    std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), sizeof(T));
+                }
+                else {
+                    alloc.construct(dst, std::move(*src));
+                    alloc.destroy(src);
+                }
+            }
+        };
+
+    } // namespace detail
+
+    // ѰַĹϣϣSwissTable ṹӿ std::unordered_set ͬ
+    // ԪشĲλݡrehash  reserve ʹԪصĵַʧЧ
+    // ɾԪزʹԪصĵʧЧַΪʱֱ std::string_view Һɾ
+    template <typename T, typename Hash = hash<T>, typename Eq = equal_to<T>, typename Alloc = allocator<T>>
+    class flat_hash_set : public detail::raw_hash_set<detail::set_policy<T>, Hash, Eq, Alloc> {
+        using base = detail::raw_hash_set<detail::set_policy<T>, Hash, Eq, Alloc>;
+
+    public:
+        using base::base;
+        using base::operator=;
+
+        flat_hash_set() = default;
+    };
+
+} // namespace mystl
\ No newline at end of file
@@ -0,0 +1,240 @@
+// 4K ͼ֡ɨ׼ԣ3840x2160  RGBA ֡Լ 32MB mystl::vector Աַ
+//   malloc   Ĭϵ mystl::allocatorֻ֤ 16 ֽڶ룬4KB ҳ
+//   aligned  aligned_allocator<pixel, 64>װж룬ɨʱ std::assume_aligned ߱
+//   huge     huge_page_allocator<pixel>mmap + MADV_HUGEPAGE2MB ҳ
+// ÿַ
+//   fill     ״д֡ȱҳжϣҳʱȱҳ 512 
+//   rows     мȺͣ˳
+//   columns   16 أһУϵۼӣֱ˲ÿһжڲͬ 4KB ҳ
+// Linux  perf_event_open ͳ TLB ȱʧʱ perf_event_paranoid ƣʾ n/a
+// "huge MB" Ǵ /proc/self/smaps ڴʵ͸ҳ֧ŵĴС
+// Уframe_bench []Ĭ 5ʱʹ Release 
+
+#include "aligned_allocator.h"
+#include "vector.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+struct pixel {
+    std::uint8_t r, g, b, a;
+};
+
+constexpr std::size_t width = 3840;
+constexpr std::size_t height = 2160;
+constexpr std::size_t strip = 64 / sizeof(pixel);
+
+static volatile std::uint64_t g_sink;
+
+//  TLB ȱʧʧʱ valid() Ϊ false
+class tlb_counter {
+public:
+    tlb_counter() {
+#if defined(__linux__)
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~tlb_counter() {
+#if defined(__linux__)
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+#endif
+    }
+
+    tlb_counter(const tlb_counter&) = delete;
+    tlb_counter& operator=(const tlb_counter&) = delete;
+
+    bool valid() const {
+        return fd_ >= 0;
+    }
+
+    void start() {
+#if defined(__linux__)
+        if (fd_ >= 0) {
+            ::ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    long long stop() {
+        long long count = -1;
+#if defined(__linux__)
+        if (fd_ >= 0) {
+            ::ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+            if (::read(fd_, &count, sizeof(count)) != sizeof(count)) {
+                count = -1;
+            }
+        }
+#endif
+        return count;
+    }
+
+private:
+    int fd_ = -1;
+};
+
+//  /proc/self/smaps ҵ addr ӳ䣬͸ҳ֧ŵֽʱ -1
+static long long huge_bytes(const void* addr) {
+#if defined(__linux__)
+    std::ifstream smaps("/proc/self/smaps");
+    std::string line;
+    std::uintptr_t p = reinterpret_cast<std::uintptr_t>(addr);
+    bool inside = false;
+    while (std::getline(smaps, line)) {
+        unsigned long long lo = 0, hi = 0;
+        char dash = 0;
+        std::istringstream head(line);
+        if (head >> std::hex >> lo >> dash >> hi && dash == '-') {
+            inside = lo <= p && p < hi;
+        }
+        else if (inside && line.compare(0, 14, "AnonHugePages:") == 0) {
+            return std::strtoll(line.c_str() + 14, nullptr, 10) * 1024;
+        }
+    }
+#endif
+    (void)addr;
+    return -1;
+}
+
+// Ⱥ͡Align ׵Ķ뱣֤֡ 16 صַʱÿһе׶
+template <std::size_t Align>
+std::uint64_t scan_rows(const pixel* frame) {
+    std::uint64_t sum = 0;
+    for (std::size_t y = 0; y < height; ++y) {
+        const pixel* row = std::assume_aligned<Align>(frame + y * width);
+        std::uint32_t acc = 0;
+        for (std::size_t x = 0; x < width; ++x) {
+            acc += 77u * row[x].r + 150u * row[x].g + 29u * row[x].b;
+        }
+        sum += acc >> 8;
+    }
+    return sum;
+}
+
+// пϵۼӣηһУ15KB
+template <std::size_t Align>
+std::uint64_t scan_columns(const pixel* frame) {
+    std::uint64_t sum = 0;
+    for (std::size_t x0 = 0; x0 < width; x0 += strip) {
+        std::uint32_t acc[strip] = {};
+        for (std::size_t y = 0; y < height; ++y) {
+            const pixel* line = std::assume_aligned<Align>(frame + y * width + x0);
+            for (std::size_t k = 0; k < strip; ++k) {
+                acc[k] += line[k].g;
+            }
+        }
+        for (std::size_t k = 0; k < strip; ++k) {
+            sum += acc[k];
+        }
+    }
+    return sum;
+}
+
+struct Result {
+    double fill_ms;
+    double rows_ms;
+    double columns_ms;
+    long long rows_tlb;
+    long long columns_tlb;
+    long long huge;
+};
+
+template <typename Alloc, std::size_t Align>
+Result run(int passes, tlb_counter& tlb) {
+    Result r{};
+    mystl::vector<pixel, Alloc> frame;
+
+    auto start = Clock::now();
+    frame.resize_for_overwrite(width * height);
+    for (std::size_t i = 0; i < frame.size(); ++i) {
+        frame[i] = pixel{ std::uint8_t(i), std::uint8_t(i >> 8), std::uint8_t(i >> 16), 255 };
+    }
+    r.fill_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    r.huge = huge_bytes(frame.data());
+
+    // ÿ鶼 volatile ¶ȡַ޷Ѹͬɨϲһ
+    const pixel* volatile data = frame.data();
+    std::uint64_t sum = 0;
+    tlb.start();
+    start = Clock::now();
+    for (int p = 0; p < passes; ++p) {
+        sum += scan_rows<Align>(data);
+    }
+    r.rows_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / passes;
+    r.rows_tlb = tlb.stop();
+
+    tlb.start();
+    start = Clock::now();
+    for (int p = 0; p < passes; ++p) {
+        sum += scan_columns<Align>(data);
+    }
+    r.columns_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / passes;
+    r.columns_tlb = tlb.stop();
+    if (r.rows_tlb >= 0) {
+        r.rows_tlb /= passes;
+        r.columns_tlb /= passes;
+    }
+
+    g_sink = sum;
+    return r;
+}
+
+static std::string count_or_na(long long v) {
+    return v < 0 ? std::string("n/a") : std::to_string(v);
+}
+
+static void print_row(const char* name, const Result& r) {
+    double bytes = double(width) * height * sizeof(pixel);
+    std::cout << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << r.fill_ms
+              << std::setw(10) << r.rows_ms << std::setw(10) << bytes / r.rows_ms / 1e6
+              << std::setw(12) << count_or_na(r.rows_tlb)
+              << std::setw(10) << r.columns_ms << std::setw(12) << count_or_na(r.columns_tlb)
+              << std::setw(10) << (r.huge < 0 ? std::string("n/a") : std::to_string(r.huge >> 20)) << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    int passes = argc > 1 ? std::atoi(argv[1]) : 5;
+    if (passes <= 0) {
+        passes = 1;
+    }
+
+    tlb_counter tlb;
+    std::cout << "frame: " << width << "x" << height << " RGBA, " << width * height * sizeof(pixel) / (1 << 20)
+              << " MB, passes: " << passes << (tlb.valid() ? "" : ", dTLB counter unavailable") << "\n\n";
+    std::cout << std::left << std::setw(10) << "allocator" << std::right
+              << std::setw(10) << "fill ms" << std::setw(10) << "rows ms" << std::setw(10) << "rows GB/s"
+              << std::setw(12) << "rows dTLB" << std::setw(10) << "cols ms" << std::setw(12) << "cols dTLB"
+              << std::setw(10) << "huge MB" << "\n";
+    print_row("malloc", run<mystl::allocator<pixel>, alignof(std::max_align_t)>(passes, tlb));
+    print_row("aligned", run<mystl::aligned_allocator<pixel, 64>, 64>(passes, tlb));
+    print_row("huge", run<mystl::huge_page_allocator<pixel>, 64>(passes, tlb));
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+// ϣ׼ԣmystl::flat_hash_map  std::unordered_map Ա
+//   insert    n Ԥռ䣩
+//   reserve   reserve(n) ٲ
+//   hit       n ڵļ
+//   miss      n ڵļ
+//   erase    ɾһԪ
+// ֱ 64 λ "/api/v1/resource/123" ··ַַĲҼ std::string_view
+// 󻺳г·std::unordered_map<std::string, ...> Ҫȹʱ std::string
+// flat_hash_map ֱ string_view 
+// Уhash_bench [Ԫظ]Ĭ 1000000ʱʹ Release 
+
+#include "flat_hash_map.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+struct Result {
+    double insert_ms;
+    double reserve_ms;
+    double hit_ms;
+    double miss_ms;
+    double erase_ms;
+};
+
+static volatile std::size_t g_sink;
+
+static double ms_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// õļֱüַ std::string ת std::string_view
+template <typename Key>
+using lookup_key = std::conditional_t<std::is_same_v<Key, std::string>, std::string_view, Key>;
+
+// std::unordered_map  find ֻ key_typestring_view Ҫת std::string
+template <typename Map, typename L>
+auto find_in(Map& m, const L& key) {
+    if constexpr (std::is_same_v<L, std::string_view> && !std::is_same_v<Map, mystl::flat_hash_map<std::string, int>>) {
+        return m.find(std::string(key));
+    }
+    else {
+        return m.find(key);
+    }
+}
+
+template <typename Map, typename Key>
+Result run(const std::vector<Key>& keys, const std::vector<Key>& missing) {
+    using L = lookup_key<Key>;
+    std::vector<L> hit_keys(keys.begin(), keys.end());
+    std::vector<L> miss_keys(missing.begin(), missing.end());
+    Result r{};
+
+    {
+        Map m;
+        auto start = Clock::now();
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            m.emplace(keys[i], static_cast<int>(i));
+        }
+        r.insert_ms = ms_since(start);
+    }
+
+    Map m;
+    auto start = Clock::now();
+    m.reserve(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        m.emplace(keys[i], static_cast<int>(i));
+    }
+    r.reserve_ms = ms_since(start);
+
+    std::size_t sum = 0;
+    start = Clock::now();
+    for (const L& k : hit_keys) {
+        sum += find_in(m, k)->second;
+    }
+    r.hit_ms = ms_since(start);
+
+    start = Clock::now();
+    for (const L& k : miss_keys) {
+        sum += find_in(m, k) == m.end();
+    }
+    r.miss_ms = ms_since(start);
+
+    start = Clock::now();
+    for (std::size_t i = 0; i < keys.size(); i += 2) {
+        sum += m.erase(keys[i]);
+    }
+    r.erase_ms = ms_since(start);
+
+    g_sink = sum;
+    return r;
+}
+
+static void print_row(const char* name, const Result& r) {
+    std::cout << std::left << std::setw(26) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(11) << r.insert_ms << std::setw(11) << r.reserve_ms << std::setw(11) << r.hit_ms
+              << std::setw(11) << r.miss_ms << std::setw(11) << r.erase_ms << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    std::mt19937_64 rng(42);
+    std::vector<std::uint64_t> ints(n), missing_ints(n);
+    for (auto& k : ints) {
+        k = rng() | 1;
+    }
+    for (auto& k : missing_ints) {
+        k = rng() & ~std::uint64_t(1);
+    }
+
+    static const char* const resources[] = { "users", "orders", "images", "sessions", "files", "devices" };
+    std::vector<std::string> paths(n), missing_paths(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        paths[i] = "/api/v1/" + std::string(resources[i % 6]) + "/" + std::to_string(i);
+        missing_paths[i] = "/api/v2/" + std::string(resources[i % 6]) + "/" + std::to_string(i);
+    }
+
+    std::cout << "elements: " << n << "\n\n";
+    std::cout << std::left << std::setw(26) << "map" << std::right
+              << std::setw(11) << "insert ms" << std::setw(11) << "reserve ms" << std::setw(11) << "hit ms"
+              << std::setw(11) << "miss ms" << std::setw(11) << "erase ms" << "\n";
+    print_row("std::unordered_map<u64>", run<std::unordered_map<std::uint64_t, int>>(ints, missing_ints));
+    print_row("flat_hash_map<u64>", run<mystl::flat_hash_map<std::uint64_t, int>>(ints, missing_ints));
+    print_row("std::unordered_map<str>", run<std::unordered_map<std::string, int>>(paths, missing_paths));
+    print_row("flat_hash_map<str>", run<mystl::flat_hash_map<std::string, int>>(paths, missing_paths));
+    return 0;
+}
\ No newline at end of file
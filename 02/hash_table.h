@@ -0,0 +1,903 @@
+#pragma once
+#include "allocator.h"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MYSTL_HASH_TABLE_SSE2 1
+#endif
+
+
+
+namespace mystl {
+
+    // ϣĬʹõĹϣһ; std::hashַͻ͸ string_hash
+    //  std::string Ϊıֱ std::string_viewconst char* ңʱ std::string
+    struct string_hash {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view s) const noexcept {
+            return std::hash<std::string_view>()(s);
+        }
+    };
+
+    template <typename T>
+    struct hash : std::hash<T> {};
+
+    template <>
+    struct hash<std::string> : string_hash {};
+
+    template <>
+    struct hash<std::string_view> : string_hash {};
+
+    //  hash ׵ȱȽϣַͬ͸
+    template <typename T>
+    struct equal_to : std::equal_to<T> {};
+
+    template <>
+    struct equal_to<std::string> : std::equal_to<> {};
+
+    template <>
+    struct equal_to<std::string_view> : std::equal_to<> {};
+
+    namespace detail {
+
+        // ֽڣÿλһλΪ 0 ʾλռã 7 λŹϣֵĵ 7 λH2
+        // ״̬λΪ 1һзűȽֳ"ջɾ"
+        using ctrl_t = signed char;
+        inline constexpr ctrl_t ctrl_empty = -128;     // 0b10000000
+        inline constexpr ctrl_t ctrl_deleted = -2;     // 0b11111110ĹʱҪԽ̽
+        inline constexpr ctrl_t ctrl_sentinel = -1;    // 0b11111111ֽĩβڱ
+
+        inline bool is_full(ctrl_t c) noexcept {
+            return c >= 0;
+        }
+
+        // һֽڵƥÿλռ 1 << Shift λʱθƥλ±
+        template <typename Mask, int Width, int Shift>
+        class bit_mask {
+        public:
+            explicit bit_mask(Mask mask) noexcept : mask_(mask) {}
+
+            explicit operator bool() const noexcept {
+                return mask_ != 0;
+            }
+
+            int lowest() const noexcept {
+                return std::countr_zero(mask_) >> Shift;
+            }
+
+            // ٸλƥ
+            int trailing_zeros() const noexcept {
+                return std::countr_zero(mask_) >> Shift;
+            }
+
+            // βٸλƥ
+            int leading_zeros() const noexcept {
+                constexpr int extra = static_cast<int>(sizeof(Mask) * 8) - (Width << Shift);
+                return (std::countl_zero(static_cast<Mask>(mask_ << extra))) >> Shift;
+            }
+
+            bit_mask begin() const noexcept {
+                return *this;
+            }
+
+            bit_mask end() const noexcept {
+                return bit_mask(0);
+            }
+
+            int operator*() const noexcept {
+                return lowest();
+            }
+
+            bit_mask& operator++() noexcept {
+                mask_ &= mask_ - 1;
+                return *this;
+            }
+
+            bool operator!=(const bit_mask& other) const noexcept {
+                return mask_ != other.mask_;
+            }
+
+        private:
+            Mask mask_;
+        };
+
+#if defined(MYSTL_HASH_TABLE_SSE2)
+        // SSE2 汾һμ 16 ֽڣһȽָõƥ
+        struct group {
+            static constexpr std::size_t width = 16;
+            using mask_type = bit_mask<std::uint32_t, 16, 0>;
+
+            explicit group(const ctrl_t* pos) noexcept
+                : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+            // H2  h Ĳλ
+            mask_type match(ctrl_t h) const noexcept {
+                return mask_type(static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h), ctrl))));
+            }
+
+            mask_type match_empty() const noexcept {
+                return match(ctrl_empty);
+            }
+
+            // ջɾСڱֵ -1 Ŀֽ
+            mask_type match_empty_or_deleted() const noexcept {
+                return mask_type(static_cast<std::uint32_t>(
+                    _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(ctrl_sentinel), ctrl))));
+            }
+
+            // Ŀջɾλʱһ
+            std::size_t count_leading_empty_or_deleted() const noexcept {
+                std::uint32_t mask = static_cast<std::uint32_t>(
+                    _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(ctrl_sentinel), ctrl)));
+                return static_cast<std::size_t>(std::countr_one(mask));
+            }
+
+            __m128i ctrl;
+        };
+#else
+        // ͨð汾 8 ֽڵһ 64 λλ㲢бȽϣСУ
+        // match 󱨣÷ܻٱȽϼӰ
+        struct group {
+            static constexpr std::size_t width = 8;
+            using mask_type = bit_mask<std::uint64_t, 8, 3>;
+
+            static constexpr std::uint64_t lsbs = 0x0101010101010101ULL;
+            static constexpr std::uint64_t msbs = 0x8080808080808080ULL;
+
+            explicit group(const ctrl_t* pos) noexcept {
+                std::memcpy(&ctrl, pos, sizeof(ctrl));
+            }
+
+            mask_type match(ctrl_t h) const noexcept {
+                std::uint64_t x = ctrl ^ (lsbs * static_cast<unsigned char>(h));
+                return mask_type((x - lsbs) & ~x & msbs);
+            }
+
+            mask_type match_empty() const noexcept {
+                return mask_type((ctrl & ~(ctrl << 6)) & msbs);
+            }
+
+            mask_type match_empty_or_deleted() const noexcept {
+                return mask_type((ctrl & ~(ctrl << 7)) & msbs);
+            }
+
+            std::size_t count_leading_empty_or_deleted() const noexcept {
+                constexpr std::uint64_t gaps = 0x00FEFEFEFEFEFEFEULL;
+                return static_cast<std::size_t>((std::countr_zero(((~ctrl & (ctrl >> 7)) | gaps) + 1) + 7) >> 3);
+            }
+
+            std::uint64_t ctrl;
+        };
+#endif
+
+        // std::hash Ǻӳ䣬λ͸λٻһΣH1  H2 ֲܶ
+        inline std::size_t mix_hash(std::size_t h) noexcept {
+            if constexpr (sizeof(std::size_t) == 8) {
+                h ^= h >> 33;
+                h *= 0xff51afd7ed558ccdULL;
+                h ^= h >> 33;
+            }
+            else {
+                h ^= h >> 16;
+                h *= 0x85ebca6bU;
+                h ^= h >> 13;
+            }
+            return h;
+        }
+
+        // ϣֵȥ 7 λĲ֣һ鿪ʼ̽
+        inline std::size_t h1(std::size_t hash) noexcept {
+            return hash >> 7;
+        }
+
+        // ϣֵĵ 7 λֽ
+        inline ctrl_t h2(std::size_t hash) noexcept {
+            return static_cast<ctrl_t>(hash & 0x7f);
+        }
+
+        // Ķ̽⣺ i һελǰ i 飬 2 ݼ 1 ʱܸ
+        class probe_seq {
+        public:
+            probe_seq(std::size_t hash, std::size_t mask) noexcept : mask_(mask), offset_(hash & mask), index_(0) {}
+
+            std::size_t offset() const noexcept {
+                return offset_;
+            }
+
+            std::size_t offset(std::size_t i) const noexcept {
+                return (offset_ + i) & mask_;
+            }
+
+            void next() noexcept {
+                index_ += group::width;
+                offset_ = (offset_ + index_) & mask_;
+            }
+
+        private:
+            std::size_t mask_;
+            std::size_t offset_;
+            std::size_t index_;
+        };
+
+        // λΪ capacity ʱŶٸԪأ 7/8һղ۱ֹ֤
+        inline std::size_t capacity_to_growth(std::size_t capacity) noexcept {
+            return capacity - std::max<std::size_t>(capacity / 8, 1);
+        }
+
+        // ܴ n ԪصС2 ݼ 1ҲСһ 1
+        inline std::size_t capacity_for(std::size_t n) noexcept {
+            std::size_t capacity = group::width - 1;
+            while (capacity_to_growth(capacity) < n) {
+                capacity = capacity * 2 + 1;
+            }
+            return capacity;
+        }
+
+        template <bool Transparent>
+        struct key_arg_select {
+            template <typename K, typename Key>
+            using type = K;
+        };
+
+        template <>
+        struct key_arg_select<false> {
+            template <typename K, typename Key>
+            using type = Key;
+        };
+
+        // ѰַϣSwissTable ṹflat_hash_set  flat_hash_map Ĺͬʵ֡
+        // ԪֱӴһλһֽ¼ÿλ״̬͹ϣֵ 7 λ
+        // ʱһαȽһֽڣֻ 7 λҲͬĲλȥȽϼֻһС
+        // ڷͬһڴǰ capacity λ capacity + 1 ֽ
+        // һڱټϿͷ width - 1 ֽڵĸκλüһ鶼Խ硣
+        // Policy λʲôȡ flat_hash_set.h  flat_hash_map.h
+        template <typename Policy, typename Hash, typename Eq, typename Alloc>
+        class raw_hash_set {
+        public:
+            using key_type = typename Policy::key_type;
+            using value_type = typename Policy::value_type;
+            using slot_type = typename Policy::slot_type;
+            using hasher = Hash;
+            using key_equal = Eq;
+            using allocator_type = Alloc;
+            using size_type = std::size_t;
+            using difference_type = std::ptrdiff_t;
+            using reference = value_type&;
+            using const_reference = const value_type&;
+            using pointer = value_type*;
+            using const_pointer = const value_type*;
+
+        private:
+            using slot_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<slot_type>;
+
+            static constexpr bool transparent = requires { typename Hash::is_transparent; typename Eq::is_transparent; };
+
+        protected:
+            // ϣͱȽϺ͸ʱ򣬲ҽӿڽȽϵֻͣ key_type
+            //  key_arg_select ĳԱ std::conditional_t͸ʱ K ȻԴʵƵ
+            template <typename K>
+            using key_arg = typename key_arg_select<transparent>::template type<K, key_type>;
+
+        public:
+            template <bool Const>
+            class basic_iterator {
+                friend class raw_hash_set;
+
+            public:
+                using value_type = typename raw_hash_set::value_type;
+                // ϵԪؾǼͨ޸
+                using reference = std::conditional_t<Const || Policy::constant_iterators, const value_type&, value_type&>;
+                using pointer = std::conditional_t<Const || Policy::constant_iterators, const value_type*, value_type*>;
+                using difference_type = std::ptrdiff_t;
+                using iterator_category = std::forward_iterator_tag;
+
+                basic_iterator() noexcept : ctrl_(nullptr), slot_(nullptr) {}
+
+                // iterator ʽתΪ const_iterator
+                template <bool C = Const, typename = std::enable_if_t<C>>
+                basic_iterator(const basic_iterator<false>& other) noexcept : ctrl_(other.ctrl_), slot_(other.slot_) {}
+
+                reference operator*() const noexcept {
+                    return Policy::element(slot_);
+                }
+
+                pointer operator->() const noexcept {
+                    return &Policy::element(slot_);
+                }
+
+                basic_iterator& operator++() noexcept {
+                    ++ctrl_;
+                    ++slot_;
+                    skip_empty_or_deleted();
+                    return *this;
+                }
+
+                basic_iterator operator++(int) noexcept {
+                    basic_iterator tmp = *this;
+                    ++*this;
+                    return tmp;
+                }
+
+                friend bool operator==(const basic_iterator& a, const basic_iterator& b) noexcept {
+                    return a.ctrl_ == b.ctrl_;
+                }
+
+                friend bool operator!=(const basic_iterator& a, const basic_iterator& b) noexcept {
+                    return a.ctrl_ != b.ctrl_;
+                }
+
+            private:
+                friend class basic_iterator<!Const>;
+
+                basic_iterator(ctrl_t* ctrl, slot_type* slot) noexcept : ctrl_(ctrl), slot_(slot) {}
+
+                // ղۺĹһһпͷλߵڱʱ end()
+                void skip_empty_or_deleted() noexcept {
+                    while (*ctrl_ < ctrl_sentinel) {
+                        std::size_t shift = group(ctrl_).count_leading_empty_or_deleted();
+                        ctrl_ += shift;
+                        slot_ += shift;
+                    }
+                    if (*ctrl_ == ctrl_sentinel) {
+                        ctrl_ = nullptr;
+                        slot_ = nullptr;
+                    }
+                }
+
+                ctrl_t* ctrl_;          // end() ʱΪ
+                slot_type* slot_;
+            };
+
+            using iterator = basic_iterator<false>;
+            using const_iterator = basic_iterator<true>;
+
+        private:
+            ctrl_t* ctrl_;              // ֽ飬ձʱΪ
+            slot_type* slots_;
+            size_type size_;
+            size_type capacity_;        // λ0  2 ݼ 1
+            size_type growth_left_;     // ݻٷŶٸԪأĹλ
+            [[no_unique_address]] Hash hash_;
+            [[no_unique_address]] Eq eq_;
+            [[no_unique_address]] slot_allocator allocator_;
+
+        public:
+            // 캯
+            raw_hash_set() noexcept(noexcept(Hash()) && noexcept(Eq()) && noexcept(Alloc()))
+                : ctrl_(nullptr), slots_(nullptr), size_(0), capacity_(0), growth_left_(0) {}
+
+            explicit raw_hash_set(size_type bucket_count, const Hash& hash = Hash(), const Eq& eq = Eq(),
+                const Alloc& alloc = Alloc())
+                : ctrl_(nullptr), slots_(nullptr), size_(0), capacity_(0), growth_left_(0),
+                hash_(hash), eq_(eq), allocator_(alloc) {
+                if (bucket_count > 0) {
+                    resize(capacity_for(bucket_count));
+                }
+            }
+
+            explicit raw_hash_set(const Alloc& alloc)
+                : raw_hash_set(0, Hash(), Eq(), alloc) {}
+
+            template <std::input_iterator InputIt>
+            raw_hash_set(InputIt first, InputIt last, size_type bucket_count = 0, const Hash& hash = Hash(),
+                const Eq& eq = Eq(), const Alloc& alloc = Alloc())
+                : raw_hash_set(bucket_count, hash, eq, alloc) {
+                insert(first, last);
+            }
+
+            raw_hash_set(std::initializer_list<value_type> init, size_type bucket_count = 0, const Hash& hash = Hash(),
+                const Eq& eq = Eq(), const Alloc& alloc = Alloc())
+                : raw_hash_set(init.begin(), init.end(), bucket_count, hash, eq, alloc) {}
+
+            raw_hash_set(const raw_hash_set& other)
+                : raw_hash_set(0, other.hash_, other.eq_,
+                    std::allocator_traits<slot_allocator>::select_on_container_copy_construction(other.allocator_)) {
+                reserve(other.size());
+                for (const auto& v : other) {
+                    insert_unique(v);
+                }
+            }
+
+            raw_hash_set(raw_hash_set&& other) noexcept
+                : ctrl_(other.ctrl_), slots_(other.slots_), size_(other.size_), capacity_(other.capacity_),
+                growth_left_(other.growth_left_), hash_(std::move(other.hash_)), eq_(std::move(other.eq_)),
+                allocator_(std::move(other.allocator_)) {
+                other.reset_empty();
+            }
+
+            // 
+            ~raw_hash_set() {
+                destroy_and_deallocate();
+            }
+
+            // ֵ
+            raw_hash_set& operator=(const raw_hash_set& other) {
+                if (this != &other) {
+                    raw_hash_set tmp(other);
+                    swap(tmp);
+                }
+                return *this;
+            }
+
+            raw_hash_set& operator=(raw_hash_set&& other) noexcept {
+                if (this != &other) {
+                    destroy_and_deallocate();
+                    ctrl_ = other.ctrl_;
+                    slots_ = other.slots_;
+                    size_ = other.size_;
+                    capacity_ = other.capacity_;
+                    growth_left_ = other.growth_left_;
+                    hash_ = std::move(other.hash_);
+                    eq_ = std::move(other.eq_);
+                    allocator_ = std::move(other.allocator_);
+                    other.reset_empty();
+                }
+                return *this;
+            }
+
+            raw_hash_set& operator=(std::initializer_list<value_type> ilist) {
+                clear();
+                insert(ilist);
+                return *this;
+            }
+
+            // 
+            iterator begin() noexcept {
+                if (size_ == 0) {
+                    return end();
+                }
+                iterator it(ctrl_, slots_);
+                it.skip_empty_or_deleted();
+                return it;
+            }
+
+            const_iterator begin() const noexcept {
+                return const_cast<raw_hash_set*>(this)->begin();
+            }
+
+            const_iterator cbegin() const noexcept {
+                return begin();
+            }
+
+            iterator end() noexcept {
+                return iterator();
+            }
+
+            const_iterator end() const noexcept {
+                return const_iterator();
+            }
+
+            const_iterator cend() const noexcept {
+                return end();
+            }
+
+            // 
+            bool empty() const noexcept {
+                return size_ == 0;
+            }
+
+            size_type size() const noexcept {
+                return size_;
+            }
+
+            // λܷ capacity() * 7 / 8 Ԫ
+            size_type capacity() const noexcept {
+                return capacity_;
+            }
+
+            size_type max_size() const noexcept {
+                return std::allocator_traits<slot_allocator>::max_size(allocator_) / 2;
+            }
+
+            float load_factor() const noexcept {
+                return capacity_ == 0 ? 0.0f : static_cast<float>(size_) / static_cast<float>(capacity_);
+            }
+
+            float max_load_factor() const noexcept {
+                return 7.0f / 8.0f;
+            }
+
+            // Ԥܷ n ԪصĿռ䣬ֻ·һΣ֮벻 n Ԫض
+            void reserve(size_type n) {
+                if (n > size_ + growth_left_) {
+                    resize(capacity_for(n));
+                }
+            }
+
+            //  n Ԫ½n СڵǰԪظʱԪظͬʱĹn Ϊ 0 ұΪʱͷڴ
+            void rehash(size_type n) {
+                if (n == 0 && size_ == 0) {
+                    destroy_and_deallocate();
+                    reset_empty();
+                    return;
+                }
+                resize(capacity_for(std::max(n, size_)));
+            }
+
+            // ޸
+            // ԪأѷĲλ
+            void clear() noexcept {
+                if (capacity_ == 0) {
+                    return;
+                }
+                destroy_slots();
+                reset_ctrl();
+                size_ = 0;
+                growth_left_ = capacity_to_growth(capacity_);
+            }
+
+            std::pair<iterator, bool> insert(const value_type& value) {
+                return insert_unique(value);
+            }
+
+            std::pair<iterator, bool> insert(value_type&& value) {
+                return insert_unique(std::move(value));
+            }
+
+            iterator insert(const_iterator, const value_type& value) {
+                return insert(value).first;
+            }
+
+            iterator insert(const_iterator, value_type&& value) {
+                return insert(std::move(value)).first;
+            }
+
+            template <std::input_iterator InputIt>
+            void insert(InputIt first, InputIt last) {
+                if constexpr (std::forward_iterator<InputIt>) {
+                    reserve(size_ + static_cast<size_type>(std::distance(first, last)));
+                }
+                for (; first != last; ++first) {
+                    insert_unique(*first);
+                }
+            }
+
+            void insert(std::initializer_list<value_type> ilist) {
+                insert(ilist.begin(), ilist.end());
+            }
+
+            // ջϹԪزõѴʱʱԪֱ
+            template <typename... Args>
+            std::pair<iterator, bool> emplace(Args&&... args) {
+                value_type tmp(std::forward<Args>(args)...);
+                return insert_unique(std::move(tmp));
+            }
+
+            template <typename... Args>
+            iterator emplace_hint(const_iterator, Args&&... args) {
+                return emplace(std::forward<Args>(args)...).first;
+            }
+
+            // ɾ󷵻һԪصĵ
+            iterator erase(const_iterator pos) {
+                iterator it(pos.ctrl_, pos.slot_);
+                iterator next = it;
+                ++next;
+                erase_slot(static_cast<size_type>(it.ctrl_ - ctrl_));
+                return next;
+            }
+
+            iterator erase(iterator pos) {
+                return erase(const_iterator(pos));
+            }
+
+            iterator erase(const_iterator first, const_iterator last) {
+                while (first != last) {
+                    first = erase(first);
+                }
+                return iterator(last.ctrl_, last.slot_);
+            }
+
+            template <typename K = key_type>
+            size_type erase(const key_arg<K>& key) {
+                size_type index;
+                if (!find_index(key, index)) {
+                    return 0;
+                }
+                erase_slot(index);
+                return 1;
+            }
+
+            void swap(raw_hash_set& other) noexcept {
+                std::swap(ctrl_, other.ctrl_);
+                std::swap(slots_, other.slots_);
+                std::swap(size_, other.size_);
+                std::swap(capacity_, other.capacity_);
+                std::swap(growth_left_, other.growth_left_);
+                std::swap(hash_, other.hash_);
+                std::swap(eq_, other.eq_);
+                std::swap(allocator_, other.allocator_);
+            }
+
+            // 
+            template <typename K = key_type>
+            iterator find(const key_arg<K>& key) {
+                size_type index;
+                if (!find_index(key, index)) {
+                    return end();
+                }
+                return iterator(ctrl_ + index, slots_ + index);
+            }
+
+            template <typename K = key_type>
+            const_iterator find(const key_arg<K>& key) const {
+                return const_cast<raw_hash_set*>(this)->find(key);
+            }
+
+            template <typename K = key_type>
+            bool contains(const key_arg<K>& key) const {
+                size_type index;
+                return const_cast<raw_hash_set*>(this)->find_index(key, index);
+            }
+
+            template <typename K = key_type>
+            size_type count(const key_arg<K>& key) const {
+                return contains(key) ? 1 : 0;
+            }
+
+            template <typename K = key_type>
+            std::pair<iterator, iterator> equal_range(const key_arg<K>& key) {
+                iterator it = find(key);
+                if (it == end()) {
+                    return { it, it };
+                }
+                iterator next = it;
+                return { it, ++next };
+            }
+
+            template <typename K = key_type>
+            std::pair<const_iterator, const_iterator> equal_range(const key_arg<K>& key) const {
+                auto range = const_cast<raw_hash_set*>(this)->equal_range(key);
+                return { range.first, range.second };
+            }
+
+            // ۲
+            hasher hash_function() const {
+                return hash_;
+            }
+
+            key_equal key_eq() const {
+                return eq_;
+            }
+
+            allocator_type get_allocator() const {
+                return allocator_type(allocator_);
+            }
+
+            friend bool operator==(const raw_hash_set& a, const raw_hash_set& b) {
+                if (a.size() != b.size()) {
+                    return false;
+                }
+                for (const auto& v : a) {
+                    auto it = b.find(Policy::key(v));
+                    if (it == b.end() || !Policy::equal_value(v, *it)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+        protected:
+            //  keyҵʱλ± falseռһλֻд˿ֽڣԪδ죩 true
+            // ÷ڷ true ĲλϹԪأʧʱ abandon_slot
+            template <typename K>
+            std::pair<size_type, bool> find_or_prepare_insert(const K& key) {
+                std::size_t hash = mix_hash(hash_(key));
+                if (capacity_ != 0) {
+                    probe_seq seq(h1(hash), capacity_);
+                    while (true) {
+                        group g(ctrl_ + seq.offset());
+                        for (int i : g.match(h2(hash))) {
+                            size_type index = seq.offset(i);
+                            if (eq_(Policy::key(Policy::element(slots_ + index)), key)) {
+                                return { index, false };
+                            }
+                        }
+                        if (g.match_empty()) {
+                            break;
+                        }
+                        seq.next();
+                    }
+                }
+                return { prepare_insert(hash), true };
+            }
+
+            //  find_or_prepare_insert ռµĲλ
+            void abandon_slot(size_type index) noexcept {
+                --size_;
+                erase_meta(index);
+            }
+
+            slot_type* slot_at(size_type index) noexcept {
+                return slots_ + index;
+            }
+
+            iterator iterator_at(size_type index) noexcept {
+                return iterator(ctrl_ + index, slots_ + index);
+            }
+
+            slot_allocator& slot_alloc() noexcept {
+                return allocator_;
+            }
+
+        private:
+            template <typename V>
+            std::pair<iterator, bool> insert_unique(V&& value) {
+                auto [index, inserted] = find_or_prepare_insert(Policy::key(value));
+                if (inserted) {
+                    try {
+                        Policy::construct(allocator_, slots_ + index, std::forward<V>(value));
+                    }
+                    catch (...) {
+                        abandon_slot(index);
+                        throw;
+                    }
+                }
+                return { iterator_at(index), inserted };
+            }
+
+            template <typename K>
+            bool find_index(const K& key, size_type& index) {
+                if (capacity_ == 0) {
+                    return false;
+                }
+                std::size_t hash = mix_hash(hash_(key));
+                probe_seq seq(h1(hash), capacity_);
+                while (true) {
+                    group g(ctrl_ + seq.offset());
+                    for (int i : g.match(h2(hash))) {
+                        index = seq.offset(i);
+                        if (eq_(Policy::key(Policy::element(slots_ + index)), key)) {
+                            return true;
+                        }
+                    }
+                    if (g.match_empty()) {
+                        return false;
+                    }
+                    seq.next();
+                }
+            }
+
+            // ̽ҵһղۻĹ
+            size_type find_first_non_full(std::size_t hash) const noexcept {
+                probe_seq seq(h1(hash), capacity_);
+                while (true) {
+                    group g(ctrl_ + seq.offset());
+                    if (auto mask = g.match_empty_or_deleted()) {
+                        return seq.offset(mask.lowest());
+                    }
+                    seq.next();
+                }
+            }
+
+            size_type prepare_insert(std::size_t hash) {
+                size_type index = capacity_ == 0 ? 0 : find_first_non_full(hash);
+                if (growth_left_ == 0 && (capacity_ == 0 || ctrl_[index] != ctrl_deleted)) {
+                    rehash_and_grow_if_necessary();
+                    index = find_first_non_full(hash);
+                }
+                ++size_;
+                growth_left_ -= ctrl_[index] == ctrl_empty;
+                set_ctrl(index, h2(hash));
+                return index;
+            }
+
+            // λʱĹܶࣨԪز 25/32ͰԭؽĹ
+            // ɾıΪĹһֱҲÿζؽ
+            void rehash_and_grow_if_necessary() {
+                if (capacity_ == 0) {
+                    resize(group::width - 1);
+                }
+                else if (capacity_ > group::width && size_ * 32 <= capacity_ * 25) {
+                    resize(capacity_);
+                }
+                else {
+                    resize(capacity_ * 2 + 1);
+                }
+            }
+
+            // дֽڣͬʱĩβĸ
+            void set_ctrl(size_type index, ctrl_t h) noexcept {
+                ctrl_[index] = h;
+                ctrl_[((index - (group::width - 1)) & capacity_) + (group::width - 1)] = h;
+            }
+
+            // ɾλԪءλڵ鿴ǰĿղ֮䲻һ飬˵ûв
+            // Ϊ""ֱ̽ӱɿղۣĹܽضϾ̽
+            void erase_slot(size_type index) noexcept {
+                Policy::destroy(allocator_, slots_ + index);
+                --size_;
+                erase_meta(index);
+            }
+
+            void erase_meta(size_type index) noexcept {
+                size_type index_before = (index - group::width) & capacity_;
+                auto empty_after = group(ctrl_ + index).match_empty();
+                auto empty_before = group(ctrl_ + index_before).match_empty();
+                bool was_never_full = empty_before && empty_after
+                    && static_cast<size_type>(empty_after.trailing_zeros() + empty_before.leading_zeros()) < group::width;
+                set_ctrl(index, was_never_full ? ctrl_empty : ctrl_deleted);
+                growth_left_ += was_never_full;
+            }
+
+            // ·䣬Ԫᵽ±ƽضλԪֱ memcpy
+            void resize(size_type new_capacity) {
+                ctrl_t* old_ctrl = ctrl_;
+                slot_type* old_slots = slots_;
+                size_type old_capacity = capacity_;
+
+                size_type units = slot_units(new_capacity);
+                slots_ = allocator_.allocate(units);
+                ctrl_ = reinterpret_cast<ctrl_t*>(slots_ + new_capacity);
+                capacity_ = new_capacity;
+                reset_ctrl();
+
+                for (size_type i = 0; i < old_capacity; ++i) {
+                    if (is_full(old_ctrl[i])) {
+                        std::size_t hash = mix_hash(hash_(Policy::key(Policy::element(old_slots + i))));
+                        size_type index = find_first_non_full(hash);
+                        set_ctrl(index, h2(hash));
+                        Policy::transfer(allocator_, slots_ + index, old_slots + i);
+                    }
+                }
+                growth_left_ = capacity_to_growth(capacity_) - size_;
+
+                if (old_capacity != 0) {
+                    allocator_.deallocate(old_slots, slot_units(old_capacity));
+                }
+            }
+
+            // λͿֽһҪٸ slot_type СĵԪ
+            static size_type slot_units(size_type capacity) noexcept {
+                size_type ctrl_bytes = capacity + group::width;
+                return capacity + (ctrl_bytes + sizeof(slot_type) - 1) / sizeof(slot_type);
+            }
+
+            void reset_ctrl() noexcept {
+                std::memset(ctrl_, static_cast<unsigned char>(ctrl_empty), capacity_ + group::width);
+                ctrl_[capacity_] = ctrl_sentinel;
+            }
+
+            void destroy_slots() noexcept {
+                if constexpr (!std::is_trivially_destructible_v<value_type>) {
+                    for (size_type i = 0; i < capacity_; ++i) {
+                        if (is_full(ctrl_[i])) {
+                            Policy::destroy(allocator_, slots_ + i);
+                        }
+                    }
+                }
+            }
+
+            void destroy_and_deallocate() noexcept {
+                if (capacity_ != 0) {
+                    destroy_slots();
+                    allocator_.deallocate(slots_, slot_units(capacity_));
+                }
+            }
+
+            void reset_empty() noexcept {
+                ctrl_ = nullptr;
+                slots_ = nullptr;
+                size_ = 0;
+                capacity_ = 0;
+                growth_left_ = 0;
+            }
+        };
+
+    } // namespace detail
+
+} // namespace mystl
\ No newline at end of file
@@ -0,0 +1,147 @@
+// list ׼ԣmystl::list ʹĬϵ mystl::allocatorÿڵһ malloc mystl::pool_allocator Ա
+//   build     push_back n ڵ㣬䴩СһĶѷ䣨ģͬʱе
+//   scan     ú󰴲˳ͣڵڴǷ
+//   churn    ɾһڵ㡢һλò½ڵ㣬 4n Σģӱʱ೤ɾ
+//   iterate  churn ֮ٱͣʱ˳ѱңַֻܿڵ̶ܼȡʤ
+//   threads  ÿӲ̸߳άһ롢ɾڶ߳µĿ
+// Уlist_bench [ڵ]Ĭ 1000000ʱʹ Release 
+
+#include "list.h"
+#include "pool_allocator.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+// ʱڵﳣĸأʱһص
+struct Timer {
+    long long expire;
+    void* arg;
+};
+
+template <typename T>
+using malloc_list = mystl::list<T>;
+
+template <typename T>
+using pooled_list = mystl::list<T, mystl::pool_allocator<mystl::list_node<T>>>;
+
+struct Result {
+    double build_ms;
+    double scan_ms;
+    double churn_ms;
+    double iterate_ms;
+    double threads_ms;
+};
+
+static volatile long long g_sink;
+
+static double ms_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+//  passes 飬ÿƽ
+template <typename List>
+double scan(const List& lst, int passes) {
+    long long sum = 0;
+    auto start = Clock::now();
+    for (int p = 0; p < passes; ++p) {
+        for (const Timer& t : lst) {
+            sum += t.expire;
+        }
+    }
+    g_sink = sum;
+    return ms_since(start) / passes;
+}
+
+template <template <typename> class List>
+Result run(std::size_t n) {
+    using list_type = List<Timer>;
+    Result r{};
+    std::mt19937_64 rng(42);
+
+    list_type lst;
+    std::vector<typename list_type::iterator> handles;
+    handles.reserve(n);
+
+    std::vector<char*> noise;
+    noise.reserve(n);
+
+    auto start = Clock::now();
+    for (std::size_t i = 0; i < n; ++i) {
+        handles.push_back(lst.emplace(lst.end(), Timer{ static_cast<long long>(i), nullptr }));
+        noise.push_back(static_cast<char*>(std::malloc(16 + rng() % 64)));
+    }
+    r.build_ms = ms_since(start);
+
+    const int passes = 10;
+    r.scan_ms = scan(lst, passes);
+
+    // ÿɾһڵ㣬ٰ½ڵ嵽һڵǰ棬ָеȫڵ
+    std::size_t ops = 4 * n;
+    start = Clock::now();
+    for (std::size_t k = 0; k < ops; ++k) {
+        std::size_t victim = rng() % n;
+        lst.erase(handles[victim]);
+        std::size_t where = rng() % n;
+        auto pos = where == victim ? lst.end() : handles[where];
+        handles[victim] = lst.emplace(pos, Timer{ static_cast<long long>(k), nullptr });
+    }
+    r.churn_ms = ms_since(start);
+
+    r.iterate_ms = scan(lst, passes);
+    for (char* p : noise) {
+        std::free(p);
+    }
+
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t per_thread = n / threads;
+    start = Clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([per_thread]() {
+            list_type local;
+            for (int round = 0; round < 8; ++round) {
+                for (std::size_t i = 0; i < per_thread; ++i) {
+                    local.push_back(Timer{ static_cast<long long>(i), nullptr });
+                }
+                while (local.size() > per_thread / 8) {
+                    local.pop_front();
+                }
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    r.threads_ms = ms_since(start);
+    return r;
+}
+
+static void print_row(const char* name, const Result& r) {
+    std::cout << std::left << std::setw(14) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << r.build_ms << std::setw(12) << r.scan_ms << std::setw(12) << r.churn_ms
+              << std::setw(12) << r.iterate_ms << std::setw(12) << r.threads_ms << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    if (n == 0) {
+        n = 1;
+    }
+
+    std::cout << "nodes: " << n << ", churn ops: " << 4 * n
+              << ", threads: " << std::max(1u, std::thread::hardware_concurrency()) << "\n\n";
+    std::cout << std::left << std::setw(14) << "allocator" << std::right
+              << std::setw(12) << "build ms" << std::setw(12) << "scan ms" << std::setw(12) << "churn ms"
+              << std::setw(12) << "iterate ms" << std::setw(12) << "threads ms" << "\n";
+    print_row("malloc", run<malloc_list>(n));
+    print_row("pool", run<pooled_list>(n));
+    return 0;
+}
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "list.h"
 #include "algorithm.h"
 #include <iostream>
+#include <string>
 
 
 int main() {
@@ -32,6 +33,41 @@ int main() {
     }
     std::cout << "\nSize: " << lst.size() << "\n\n";
 
+    // memory_resourceʱջϵĻ䣬һͷ
+    std::cout << "=== Testing mystl::memory_resource ===\n";
+    char buffer[1024];
+    mystl::monotonic_buffer_resource arena(buffer, sizeof(buffer));
+    {
+        mystl::vector<int, mystl::polymorphic_allocator<int>> scratch(&arena);
+        for (int i = 1; i <= 5; ++i) {
+            scratch.push_back(i * i);
+        }
+
+        std::cout << "Scratch elements: ";
+        for (const auto& num : scratch) {
+            std::cout << num << " ";
+        }
+        bool in_buffer = reinterpret_cast<char*>(scratch.data()) >= buffer
+            && reinterpret_cast<char*>(scratch.data()) < buffer + sizeof(buffer);
+        std::cout << "\nIn arena buffer: " << (in_buffer ? "yes" : "no") << "\n\n";
+    }
+    arena.release();
+
+    // ԴСֳأͷŵĿصԵĿʱľɻԱ临
+    mystl::unsynchronized_pool_resource pool;
+    {
+        mystl::vector<std::string, mystl::polymorphic_allocator<std::string>> names(&pool);
+        for (int i = 1; i <= 5; ++i) {
+            names.push_back("item" + std::to_string(i));
+        }
+
+        std::cout << "Pooled elements: ";
+        for (const auto& name : names) {
+            std::cout << name << " ";
+        }
+        std::cout << "\nSize: " << names.size() << "\n\n";
+    }
+
     // 㷨
     std::cout << "=== Testing mystl::algorithm ===\n";
     mystl::vector<int> numbers = { 5, 3, 1, 4, 2 };
@@ -0,0 +1,268 @@
+#pragma once
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+
+namespace mystl {
+
+    namespace detail {
+
+        // нڵ㣺ڵδʹʱͷֽһнڵָ
+        struct free_node {
+            free_node* next;
+        };
+
+        // ̹߳Ľڵأ飨slabϵͳڴ棬߳˳ʱĿнڵ㡣
+        // ÿֻ߳ڱػʱȡһΣһѻ͹
+        template <std::size_t Size, std::size_t Align>
+        class node_arena {
+        public:
+            static constexpr std::size_t slab_bytes = 64 * 1024;
+            static constexpr std::size_t nodes_per_slab = slab_bytes / Size > 0 ? slab_bytes / Size : 1;
+
+            // ڵڱ̡߳ھ̬ʱͷţԹرӲڽ˳ʱϵͳ
+            static node_arena& instance() {
+                static node_arena* arena = new node_arena;
+                return *arena;
+            }
+
+            // ȡ߳̽count ΪϵĽڵûʱһ飬ַֹɵ÷˳з
+            free_node* take(char*& bump, char*& bump_end, std::size_t& count) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                count = free_count_;
+                free_count_ = 0;
+                if (free_) {
+                    free_node* list = free_;
+                    free_ = nullptr;
+                    return list;
+                }
+                slab* s = static_cast<slab*>(::operator new(sizeof(slab) + nodes_per_slab * Size,
+                    std::align_val_t(slab_align)));
+                s->next = slabs_;
+                slabs_ = s;
+                bump = reinterpret_cast<char*>(s) + sizeof(slab);
+                bump_end = bump + nodes_per_slab * Size;
+                return nullptr;
+            }
+
+            //  [first, last]  count ڵĿӵͷ
+            void give(free_node* first, free_node* last, std::size_t count) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                last->next = free_;
+                free_ = first;
+                free_count_ += count;
+            }
+
+        private:
+            static constexpr std::size_t slab_align = Align > alignof(std::max_align_t) ? Align : alignof(std::max_align_t);
+
+            // ͷֻ¼һ飬Сȡֵ֤ĵһڵǶ
+            struct alignas(slab_align) slab {
+                slab* next;
+            };
+
+            node_arena() = default;
+
+            std::mutex mutex_;
+            free_node* free_ = nullptr;
+            std::size_t free_count_ = 0;
+            slab* slabs_ = nullptr;
+        };
+
+        // ÿֽڵСһĹ̶СڵءͷŶֻǰ̵߳ıػ棬ҲԭӲ
+        // ȡؿٴӵǰ˳гһڵ㣬ҲʱȥȡһΡ
+        // ̷߳Ľڵڱ߳ͷʱ뱾̵߳Ļ棬泬ʱѶһأ
+        // ߳˳ʱѻĽڵȫ
+        template <std::size_t Size, std::size_t Align>
+        class node_pool {
+        public:
+            static void* allocate() {
+                cache& c = local();
+                if (free_node* n = c.free) {
+                    c.free = n->next;
+                    --c.count;
+                    return n;
+                }
+                if (c.bump == c.bump_end) {
+                    refill(c);
+                    if (free_node* n = c.free) {
+                        c.free = n->next;
+                        --c.count;
+                        return n;
+                    }
+                }
+                void* p = c.bump;
+                c.bump += Size;
+                return p;
+            }
+
+            static void deallocate(void* p) noexcept {
+                cache& c = local();
+                free_node* n = static_cast<free_node*>(p);
+                n->next = c.free;
+                c.free = n;
+                if (++c.count > max_cached) {
+                    trim(c);
+                }
+            }
+
+        private:
+            using arena = node_arena<Size, Align>;
+
+            // ؿ໺Ľڵ㣬ʱͷŵһ飬ཻء
+            // һ߳רͷű̷߳Ľڵʱ/ߣĿڵص䷽
+            static constexpr std::size_t keep_cached = arena::nodes_per_slab;
+            static constexpr std::size_t max_cached = 2 * keep_cached;
+
+            // ƽ̵߳Ļ֮߳˳ʱ̬Կ԰ȫͷŽڵ
+            struct cache {
+                free_node* free;
+                std::size_t count;  // free ϵĽڵ
+                char* bump;
+                char* bump_end;
+                bool guarded;
+            };
+
+            // ߳˳ʱѱػ潻أЩڵԶò
+            struct cache_guard {
+                ~cache_guard() {
+                    cache& c = local();
+                    free_node* first = c.free;
+                    free_node* last = nullptr;
+                    std::size_t count = c.count;
+                    for (free_node* n = first; n; n = n->next) {
+                        last = n;
+                    }
+                    for (; c.bump != c.bump_end; c.bump += Size) {
+                        free_node* n = reinterpret_cast<free_node*>(c.bump);
+                        n->next = first;
+                        first = n;
+                        ++count;
+                        if (!last) {
+                            last = n;
+                        }
+                    }
+                    if (first) {
+                        arena::instance().give(first, last, count);
+                    }
+                    c.free = nullptr;
+                    c.count = 0;
+                }
+            };
+
+            static cache& local() noexcept {
+                thread_local cache c{ nullptr, 0, nullptr, nullptr, false };
+                return c;
+            }
+
+            // ͷ keep_cached ڵڱأ֮ν
+            static void trim(cache& c) noexcept {
+                free_node* keep_last = c.free;
+                for (std::size_t i = 1; i < keep_cached; ++i) {
+                    keep_last = keep_last->next;
+                }
+                free_node* first = keep_last->next;
+                free_node* last = first;
+                while (last->next) {
+                    last = last->next;
+                }
+                keep_last->next = nullptr;
+                arena::instance().give(first, last, c.count - keep_cached);
+                c.count = keep_cached;
+            }
+
+            static void refill(cache& c) {
+                // ̵߳һȡڵʱŴ guard֮ٴ֮ȡĽڵ߳һ
+                if (!c.guarded) {
+                    thread_local cache_guard guard;
+                    (void)guard;
+                    c.guarded = true;
+                }
+                c.free = arena::instance().take(c.bump, c.bump_end, c.count);
+            }
+        };
+
+    } // namespace detail
+
+    // ̶Сڵĳط list ڵʹã
+    //     mystl::list<int, mystl::pool_allocator<mystl::list_node<int>>>
+    // ڵ 64KB Ŀ˳гͷŵĽڵ̱߳صĿ´θãͬһĽڵڴл
+    // Сͬ͹һأһηԪʱ˻ operator newֻڽ˳ʱ黹ϵͳ
+    template <typename T>
+    class pool_allocator {
+    public:
+        // Ͷ
+        using value_type = T;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using reference = T&;
+        using const_reference = const T&;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+
+        // ȫֵģ pool_allocator ͷŶԷڴ
+        using is_always_equal = std::true_type;
+
+        pool_allocator() noexcept = default;
+
+        template <typename U>
+        pool_allocator(const pool_allocator<U>&) noexcept {}
+
+        // ڴ
+        [[nodiscard]] pointer allocate(size_type n) {
+            if (n == 1) {
+                return static_cast<pointer>(pool::allocate());
+            }
+            if (n > max_size()) {
+                throw std::bad_alloc();
+            }
+            return static_cast<pointer>(::operator new(n * sizeof(T), std::align_val_t(node_align)));
+        }
+
+        // ͷڴ
+        void deallocate(pointer p, size_type n) noexcept {
+            if (n == 1) {
+                pool::deallocate(p);
+            }
+            else {
+                ::operator delete(p, std::align_val_t(node_align));
+            }
+        }
+
+        // 
+        template <typename U, typename... Args>
+        void construct(U* p, Args&&... args) {
+            ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+        }
+
+        // ٶ
+        template <typename U>
+        void destroy(U* p) {
+            p->~U();
+        }
+
+        // ܷĴС
+        [[nodiscard]] size_type max_size() const noexcept {
+            return size_type(-1) / sizeof(T);
+        }
+
+    private:
+        // ڵҪŵһָ룻Сȡ˳зʱÿڵ㶼Ƕ
+        static constexpr std::size_t node_align = alignof(T) > alignof(detail::free_node) ? alignof(T) : alignof(detail::free_node);
+        static constexpr std::size_t node_size =
+            ((sizeof(T) > sizeof(detail::free_node) ? sizeof(T) : sizeof(detail::free_node)) + node_align - 1) & ~(node_align - 1);
+
+        using pool = detail::node_pool<node_size, node_align>;
+    };
+
+    // ȽǷ
+    template <typename T1, typename T2>
+    bool operator==(const pool_allocator<T1>&, const pool_allocator<T2>&) noexcept {
+        return true;
+    }
+
+} // namespace mystl
\ No newline at end of file
@@ -0,0 +1,274 @@
+#pragma once
+#include "allocator.h"
+#include "vector.h"
+#include <initializer_list>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
+
+
+namespace mystl {
+
+    // 洢 vector N ԪʱڶĻڴ棻
+    //  N ʱᵽڴϣ֮Ϊ mystl::vector ͬӿҲͬ
+    //  vector ͬǣƶһʹ洢 small_vector ʱԪȥģԭĵ֮ʧЧ
+    template <typename T, std::size_t N, typename Alloc = allocator<T>, typename Growth = growth_factor<3, 2>>
+    class small_vector : public detail::vector_base<small_vector<T, N, Alloc, Growth>, T, Alloc, Growth> {
+        static_assert(N > 0, "small_vector needs at least one inline element");
+
+        using base = detail::vector_base<small_vector, T, Alloc, Growth>;
+        friend base;
+
+    public:
+        // Ͷ
+        using typename base::value_type;
+        using typename base::allocator_type;
+        using typename base::size_type;
+        using typename base::difference_type;
+        using typename base::reference;
+        using typename base::const_reference;
+        using typename base::pointer;
+        using typename base::const_pointer;
+        using typename base::iterator;
+        using typename base::const_iterator;
+
+        static constexpr size_type inline_capacity = N;
+
+    private:
+        // start_ ʹ洢ʱָ buffer_
+        using base::start_;
+        using base::finish_;
+        using base::end_of_storage_;
+        using base::allocator_;
+        alignas(T) unsigned char buffer_[N * sizeof(T)];   // 洢
+
+    public:
+        using base::size;
+        using base::capacity;
+        using base::max_size;
+        using base::clear;
+        using base::assign;
+
+        // ĬϹ캯
+        small_vector() noexcept(noexcept(Alloc())) {
+            init_inline();
+        }
+
+        // ָĹ캯
+        explicit small_vector(const Alloc& alloc) noexcept : base(alloc) {
+            init_inline();
+        }
+
+        // ָСͳʼֵĹ캯
+        explicit small_vector(size_type n, const T& value = T(), const Alloc& alloc = Alloc())
+            : base(alloc) {
+            init_inline();
+            try {
+                assign(n, value);
+            }
+            catch (...) {
+                release_storage();
+                throw;
+            }
+        }
+
+        // Χ캯
+        template <std::input_iterator InputIt>
+        small_vector(InputIt first, InputIt last, const Alloc& alloc = Alloc())
+            : base(alloc) {
+            init_inline();
+            try {
+                assign(first, last);
+            }
+            catch (...) {
+                clear();
+                release_storage();
+                throw;
+            }
+        }
+
+        // ʼб캯
+        small_vector(std::initializer_list<T> init, const Alloc& alloc = Alloc())
+            : small_vector(init.begin(), init.end(), alloc) {}
+
+        // 
+        ~small_vector() {
+            clear();
+            release_storage();
+        }
+
+        // 캯
+        small_vector(const small_vector& other)
+            : small_vector(other.begin(), other.end(),
+                std::allocator_traits<Alloc>::select_on_container_copy_construction(other.allocator_)) {}
+
+        // ƶ캯Էڶʱֱӽӹܣ洢ʱ
+        small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+            : base(std::move(other.allocator_)) {
+            init_inline();
+            take(other);
+        }
+
+        // ֵ
+        small_vector& operator=(const small_vector& other) {
+            if (this != &other) {
+                assign(other.begin(), other.end());
+            }
+            return *this;
+        }
+
+        // ƶֵԷڶʱӹĿ飬ԼĶڴͷţ
+        // ܲʱԼĶڴͬҪڻ֮ǰԭķͷ
+        small_vector& operator=(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+            if (this != &other) {
+                clear();
+                if (!other.is_inline() || !std::allocator_traits<Alloc>::is_always_equal::value) {
+                    release_storage();
+                    init_inline();
+                }
+                allocator_ = std::move(other.allocator_);
+                take(other);
+            }
+            return *this;
+        }
+
+        reference at(size_type pos) {
+            if (pos >= size()) {
+                throw std::out_of_range("small_vector::at");
+            }
+            return start_[pos];
+        }
+
+        const_reference at(size_type pos) const {
+            if (pos >= size()) {
+                throw std::out_of_range("small_vector::at");
+            }
+            return start_[pos];
+        }
+
+        // ԪǷ洢
+        bool is_inline() const noexcept {
+            return start_ == reinterpret_cast<const_pointer>(buffer_);
+        }
+
+        // Ԥ n Ԫصn  N ʱʲôҲ
+        void reserve(size_type n) {
+            if (n > max_size()) {
+                throw std::length_error("small_vector::reserve");
+            }
+            if (n > capacity()) {
+                reallocate(n);
+            }
+        }
+
+        //  size()Ԫظ N ʱ洢ͷŶڴ
+        void shrink_to_fit() {
+            if (is_inline() || finish_ == end_of_storage_) {
+                return;
+            }
+            if (size() <= N) {
+                pointer old_start = start_;
+                size_type old_capacity = capacity();
+                size_type n = size();
+                pointer dst = reinterpret_cast<pointer>(buffer_);
+                relocate(old_start, finish_, dst);
+                allocator_.deallocate(old_start, old_capacity);
+                start_ = dst;
+                finish_ = dst + n;
+                end_of_storage_ = dst + N;
+                return;
+            }
+            reallocate(size());
+        }
+
+        void swap(small_vector& other) {
+            if (!is_inline() && !other.is_inline()) {
+                std::swap(start_, other.start_);
+                std::swap(finish_, other.finish_);
+                std::swap(end_of_storage_, other.end_of_storage_);
+                std::swap(allocator_, other.allocator_);
+                return;
+            }
+            small_vector tmp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(tmp);
+        }
+
+    private:
+        void init_inline() noexcept {
+            start_ = finish_ = reinterpret_cast<pointer>(buffer_);
+            end_of_storage_ = start_ + N;
+        }
+
+        // ͷŶϵĴ洢Ԫأʹ洢ʱʲôҲ
+        void release_storage() noexcept {
+            if (!is_inline()) {
+                allocator_.deallocate(start_, capacity());
+            }
+        }
+
+        //  [first, last) ᵽδʼ dst ϣԴλϵԪΪ
+        void relocate(pointer first, pointer last, pointer dst) {
+            if constexpr (is_trivially_relocatable_v<T>) {
+                if (first != last) {
+                    std::memcpy(static_cast<void*>(dst), static_cast<const void*>(first), (last - first) * sizeof(T));
+                }
+            }
+            else {
+                std::uninitialized_move(first, last, dst);
+                for (pointer p = first; p != last; ++p) {
+                    allocator_.destroy(p);
+                }
+            }
+        }
+
+        // ӹ other Ԫأ֮ other ΪաǰΪգ
+        // other ڶʱʹ洢ֱӽӹָ룩򱾶Է other Ԫ
+        void take(small_vector& other) {
+            if (!other.is_inline()) {
+                start_ = other.start_;
+                finish_ = other.finish_;
+                end_of_storage_ = other.end_of_storage_;
+                other.init_inline();
+                return;
+            }
+            size_type n = other.size();
+            relocate(other.start_, other.finish_, start_);
+            finish_ = start_ + n;
+            other.finish_ = other.start_;
+        }
+
+        // Ԫذᵽһ new_capacity ԪصĶڴϣnew_capacity Ǵ N
+        void reallocate(size_type new_capacity) {
+            size_type n = size();
+            if constexpr (is_trivially_relocatable_v<T>
+                          && requires(Alloc& a, pointer p, size_type k) { a.reallocate(p, k, k); }) {
+                if (!is_inline()) {
+                    start_ = allocator_.reallocate(start_, capacity(), new_capacity);
+                    finish_ = start_ + n;
+                    end_of_storage_ = start_ + new_capacity;
+                    return;
+                }
+            }
+
+            pointer new_start = allocator_.allocate(new_capacity);
+            try {
+                relocate(start_, finish_, new_start);
+            }
+            catch (...) {
+                allocator_.deallocate(new_start, new_capacity);
+                throw;
+            }
+            release_storage();
+            start_ = new_start;
+            finish_ = new_start + n;
+            end_of_storage_ = new_start + new_capacity;
+        }
+    };
+
+} // namespace mystl
\ No newline at end of file
@@ -0,0 +1,138 @@
+// small_vector ׼ԣ͵"ͨ 8 Ԫ"ľֲϣԱ mystl::vector  mystl::small_vector<T, 8>
+// ĺʱͷһͳƣallocate  reallocate һΣ
+//   channels  ÿ¼ѭռ 0~7 Ծ Channel ָٱ
+//   faces     ÿ֡⵽ 1~6 
+//   headers   ÿ 4~12 ͷֶΣ 8 ʱ small_vector ҲҪ
+// Уsmall_vector_bench []Ĭ 1000000
+
+#include "small_vector.h"
+#include "vector.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static std::size_t g_allocations = 0;
+
+// ͳƷķΪ mystl::allocator ͬ
+template <typename T>
+struct counting_allocator : mystl::allocator<T> {
+    using value_type = T;
+
+    counting_allocator() noexcept = default;
+
+    template <typename U>
+    counting_allocator(const counting_allocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        ++g_allocations;
+        return mystl::allocator<T>::allocate(n);
+    }
+
+    T* reallocate(T* p, std::size_t old_n, std::size_t new_n) {
+        ++g_allocations;
+        return mystl::allocator<T>::reallocate(p, old_n, new_n);
+    }
+};
+
+struct Channel {
+    int fd;
+    unsigned events;
+};
+
+struct Box {
+    float x, y, w, h;
+};
+
+using Header = std::pair<std::string_view, std::string_view>;
+
+template <typename T>
+using plain_vector = mystl::vector<T, counting_allocator<T>>;
+
+template <typename T>
+using small8 = mystl::small_vector<T, 8, counting_allocator<T>>;
+
+struct Result {
+    double ms;
+    std::size_t allocations;
+};
+
+static volatile std::size_t g_sink;
+
+template <template <typename> class Vec>
+Result bench_channels(std::size_t rounds, const std::vector<unsigned char>& counts) {
+    static Channel channels[8];
+    g_allocations = 0;
+    std::size_t sum = 0;
+    auto start = Clock::now();
+    for (std::size_t r = 0; r < rounds; ++r) {
+        Vec<Channel*> active;
+        for (unsigned char i = 0; i < counts[r] % 8; ++i) active.push_back(&channels[i]);
+        for (Channel* ch : active) sum += reinterpret_cast<std::size_t>(ch) & 0xff;
+    }
+    g_sink = sum;
+    return Result{ std::chrono::duration<double, std::milli>(Clock::now() - start).count(), g_allocations };
+}
+
+template <template <typename> class Vec>
+Result bench_faces(std::size_t rounds, const std::vector<unsigned char>& counts) {
+    g_allocations = 0;
+    float sum = 0;
+    auto start = Clock::now();
+    for (std::size_t r = 0; r < rounds; ++r) {
+        Vec<Box> faces;
+        for (unsigned char i = 0; i < 1 + counts[r] % 6; ++i) faces.push_back(Box{ float(i), float(i), 32, 32 });
+        for (const Box& b : faces) sum += b.w * b.h;
+    }
+    g_sink = static_cast<std::size_t>(sum);
+    return Result{ std::chrono::duration<double, std::milli>(Clock::now() - start).count(), g_allocations };
+}
+
+template <template <typename> class Vec>
+Result bench_headers(std::size_t rounds, const std::vector<unsigned char>& counts) {
+    static const Header pool[12] = {
+        { "Host", "example.com" }, { "User-Agent", "bench" }, { "Accept", "*/*" },
+        { "Connection", "keep-alive" }, { "Content-Type", "text/plain" }, { "Content-Length", "42" },
+        { "Cookie", "a=b" }, { "Cache-Control", "no-cache" }, { "Referer", "/" },
+        { "Accept-Encoding", "gzip" }, { "Accept-Language", "zh-CN" }, { "Origin", "null" },
+    };
+    g_allocations = 0;
+    std::size_t sum = 0;
+    auto start = Clock::now();
+    for (std::size_t r = 0; r < rounds; ++r) {
+        Vec<Header> headers;
+        for (unsigned char i = 0; i < 4 + counts[r] % 9; ++i) headers.push_back(pool[i]);
+        for (const Header& h : headers) sum += h.first.size() + h.second.size();
+    }
+    g_sink = sum;
+    return Result{ std::chrono::duration<double, std::milli>(Clock::now() - start).count(), g_allocations };
+}
+
+static void print_row(const char* name, Result v, Result s) {
+    std::cout << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << v.ms << std::setw(14) << v.allocations
+              << std::setw(14) << s.ms << std::setw(14) << s.allocations << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t rounds = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    std::vector<unsigned char> counts(rounds);
+    std::mt19937 rng(42);
+    for (auto& c : counts) c = static_cast<unsigned char>(rng());
+
+    std::cout << "rounds: " << rounds << "\n\n";
+    std::cout << std::left << std::setw(12) << "scenario" << std::right
+              << std::setw(12) << "vector ms" << std::setw(14) << "vector allocs"
+              << std::setw(14) << "small ms" << std::setw(14) << "small allocs" << "\n";
+    print_row("channels", bench_channels<plain_vector>(rounds, counts), bench_channels<small8>(rounds, counts));
+    print_row("faces", bench_faces<plain_vector>(rounds, counts), bench_faces<small8>(rounds, counts));
+    print_row("headers", bench_headers<plain_vector>(rounds, counts), bench_headers<small8>(rounds, counts));
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+// ׼ԣmystl::sort / stable_sort˳벢Уradix_sort  std::sort / std::stable_sort ڼֵϵĺʱԱ
+// ÿһΣʵͬһݵĿȡеСֵУһ
+// Уsort_bench [Ԫظ]Ĭ 1000000
+
+#include "algorithm.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+struct Sorter {
+    const char* name;
+    std::function<void(std::vector<int>::iterator, std::vector<int>::iterator)> run;
+};
+
+struct Pattern {
+    const char* name;
+    std::function<std::vector<int>(std::size_t, std::mt19937&)> make;
+};
+
+//  data Ŀ sorter rounds Σ̺ʱ룩д out
+template <typename Sorter>
+double time_sort(const std::vector<int>& data, std::vector<int>& out, int rounds, Sorter sorter) {
+    double best = 1e300;
+    for (int r = 0; r < rounds; ++r) {
+        out = data;
+        auto start = Clock::now();
+        sorter(out.begin(), out.end());
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        if (ms < best) best = ms;
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const int rounds = 5;
+
+    std::vector<Pattern> patterns = {
+        { "random", [](std::size_t n, std::mt19937& rng) {
+            std::vector<int> v(n);
+            for (auto& x : v) x = static_cast<int>(rng());
+            return v;
+        } },
+        { "sorted", [](std::size_t n, std::mt19937&) {
+            std::vector<int> v(n);
+            for (std::size_t i = 0; i < n; ++i) v[i] = static_cast<int>(i);
+            return v;
+        } },
+        { "reversed", [](std::size_t n, std::mt19937&) {
+            std::vector<int> v(n);
+            for (std::size_t i = 0; i < n; ++i) v[i] = static_cast<int>(n - i);
+            return v;
+        } },
+        { "nearly sorted", [](std::size_t n, std::mt19937& rng) {
+            std::vector<int> v(n);
+            for (std::size_t i = 0; i < n; ++i) v[i] = static_cast<int>(i);
+            for (std::size_t i = 0; i < n / 100; ++i) std::swap(v[rng() % n], v[rng() % n]);
+            return v;
+        } },
+        { "few unique", [](std::size_t n, std::mt19937& rng) {
+            std::vector<int> v(n);
+            for (auto& x : v) x = static_cast<int>(rng() % 16);
+            return v;
+        } },
+        { "organ pipe", [](std::size_t n, std::mt19937&) {
+            std::vector<int> v(n);
+            for (std::size_t i = 0; i < n; ++i) v[i] = static_cast<int>(i < n / 2 ? i : n - i);
+            return v;
+        } },
+    };
+
+    // һǻ׼еĽȽ
+    using It = std::vector<int>::iterator;
+    std::vector<Sorter> sorters = {
+        { "std::sort", [](It f, It l) { std::sort(f, l); } },
+        { "mystl::sort", [](It f, It l) { mystl::sort(f, l); } },
+        { "sort(par)", [](It f, It l) { mystl::sort(mystl::execution::par, f, l); } },
+        { "std::stable", [](It f, It l) { std::stable_sort(f, l); } },
+        { "mystl::stable", [](It f, It l) { mystl::stable_sort(f, l); } },
+        { "stable(par)", [](It f, It l) { mystl::stable_sort(mystl::execution::par, f, l); } },
+        { "radix_sort", [](It f, It l) { mystl::radix_sort(f, l); } },
+    };
+
+    std::cout << "elements: " << n << ", threads: " << std::thread::hardware_concurrency()
+              << ", best of " << rounds << " rounds (ms)\n\n";
+    std::cout << std::left << std::setw(16) << "input" << std::right;
+    for (const auto& s : sorters) std::cout << std::setw(15) << s.name;
+    std::cout << "\n";
+
+    std::mt19937 rng(12345);
+    bool ok = true;
+    for (const auto& p : patterns) {
+        std::vector<int> data = p.make(n, rng);
+        std::vector<int> expect, got;
+        std::cout << std::left << std::setw(16) << p.name << std::right << std::fixed << std::setprecision(2);
+        for (std::size_t i = 0; i < sorters.size(); ++i) {
+            double ms = time_sort(data, i == 0 ? expect : got, rounds, sorters[i].run);
+            std::cout << std::setw(15) << ms << std::flush;
+            if (i != 0 && got != expect) {
+                std::cerr << "\n" << p.name << ": " << sorters[i].name << " result mismatch\n";
+                ok = false;
+            }
+        }
+        std::cout << "\n";
+    }
+    return ok ? 0 : 1;
+}
\ No newline at end of file
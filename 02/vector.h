@@ -2,58 +2,508 @@
 #include "allocator.h"
 #include <initializer_list>
 #include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <ranges>
 #include <stdexcept>
+#include <type_traits>
 
 
 namespace mystl {
 
-    template <typename T, typename Alloc = allocator<T>>
-    class vector {
+    //  Num/DenĬ 1.5 
+    // Сڻƽʱǰͷŵļɿܷ¿飬лḴǣ2 ʱԶ
+    template <std::size_t Num, std::size_t Den>
+    struct growth_factor {
+        static_assert(Num > Den && Den > 0, "growth factor must be greater than 1");
+        static constexpr std::size_t num = Num;
+        static constexpr std::size_t den = Den;
+    };
+
+    namespace detail {
+
+        // vector  small_vector õĲָ֣롢Լ洢޹صȫ
+        // ṩ reallocate(n)Ԫذᵽ n Ԫص¿ϣ release_storage()ͷŵǰ洢Ԫأ
+        template <typename Derived, typename T, typename Alloc, typename Growth>
+        class vector_base {
+        public:
+            // Ͷ
+            using value_type = T;
+            using allocator_type = Alloc;
+            using size_type = typename std::allocator_traits<Alloc>::size_type;
+            using difference_type = typename std::allocator_traits<Alloc>::difference_type;
+            using reference = value_type&;
+            using const_reference = const value_type&;
+            using pointer = typename std::allocator_traits<Alloc>::pointer;
+            using const_pointer = typename std::allocator_traits<Alloc>::const_pointer;
+            using iterator = pointer;  // ʵָ֣Ϊ
+            using const_iterator = const_pointer;
+
+        protected:
+            pointer start_ = nullptr;      // ָһԪ
+            pointer finish_ = nullptr;     // ָһԪصһλ
+            pointer end_of_storage_ = nullptr; // ָڴĩβ
+            [[no_unique_address]] Alloc allocator_; // 
+
+            vector_base() noexcept(noexcept(Alloc())) : allocator_() {}
+
+            explicit vector_base(const Alloc& alloc) noexcept : allocator_(alloc) {}
+
+            explicit vector_base(Alloc&& alloc) noexcept : allocator_(std::move(alloc)) {}
+
+            ~vector_base() = default;
+
+        public:
+            // Ԫط
+            reference operator[](size_type pos) {
+                return start_[pos];
+            }
+
+            const_reference operator[](size_type pos) const {
+                return start_[pos];
+            }
+
+            reference front() {
+                return *start_;
+            }
+
+            const_reference front() const {
+                return *start_;
+            }
+
+            reference back() {
+                return *(finish_ - 1);
+            }
+
+            const_reference back() const {
+                return *(finish_ - 1);
+            }
+
+            pointer data() noexcept {
+                return start_;
+            }
+
+            const_pointer data() const noexcept {
+                return start_;
+            }
+
+            // 
+            iterator begin() noexcept {
+                return start_;
+            }
+
+            const_iterator begin() const noexcept {
+                return start_;
+            }
+
+            iterator end() noexcept {
+                return finish_;
+            }
+
+            const_iterator end() const noexcept {
+                return finish_;
+            }
+
+            // 
+            bool empty() const noexcept {
+                return start_ == finish_;
+            }
+
+            size_type size() const noexcept {
+                return finish_ - start_;
+            }
+
+            size_type capacity() const noexcept {
+                return end_of_storage_ - start_;
+            }
+
+            size_type max_size() const noexcept {
+                return std::allocator_traits<Alloc>::max_size(allocator_);
+            }
+
+            // ޸
+            void clear() {
+                if (start_) {
+                    for (pointer p = start_; p != finish_; ++p) {
+                        allocator_.destroy(p);
+                    }
+                    finish_ = start_;
+                }
+            }
+
+            void push_back(const T& value) {
+                emplace_back(value);
+            }
+
+            void push_back(T&& value) {
+                emplace_back(std::move(value));
+            }
+
+            template <typename... Args>
+            reference emplace_back(Args&&... args) {
+                if (finish_ == end_of_storage_) {
+                    return emplace_back_grow(std::forward<Args>(args)...);
+                }
+                allocator_.construct(finish_, std::forward<Args>(args)...);
+                ++finish_;
+                return back();
+            }
+
+            void pop_back() {
+                --finish_;
+                allocator_.destroy(finish_);
+            }
+
+            //  pos ǰԪأָһԪصĵ
+            // ʱֻһΣƽضλԪ memmove/memcpy λãԪ׷ӵĩβתλ
+            template <typename... Args>
+            iterator emplace(const_iterator pos, Args&&... args) {
+                if (pos == finish_) {
+                    size_type off = pos - start_;
+                    emplace_back(std::forward<Args>(args)...);
+                    return start_ + off;
+                }
+                // ñڵԪأȹŲ
+                T tmp(std::forward<Args>(args)...);
+                return insert_n(pos, 1, [&](pointer dst) {
+                    allocator_.construct(dst, std::move(tmp));
+                });
+            }
+
+            iterator insert(const_iterator pos, const T& value) {
+                return emplace(pos, value);
+            }
+
+            iterator insert(const_iterator pos, T&& value) {
+                return emplace(pos, std::move(value));
+            }
+
+            iterator insert(const_iterator pos, size_type n, const T& value) {
+                T tmp(value);
+                return insert_n(pos, n, [&](pointer dst) {
+                    std::uninitialized_fill_n(dst, n, tmp);
+                });
+            }
+
+            template <std::input_iterator InputIt>
+            iterator insert(const_iterator pos, InputIt first, InputIt last) {
+                if constexpr (std::forward_iterator<InputIt>) {
+                    size_type n = std::distance(first, last);
+                    return insert_n(pos, n, [&](pointer dst) {
+                        std::uninitialized_copy_n(first, n, dst);
+                    });
+                }
+                else {
+                    // ˵׷ӵĩβת pos
+                    size_type off = pos - start_;
+                    size_type old_size = size();
+                    for (; first != last; ++first) {
+                        emplace_back(*first);
+                    }
+                    std::rotate(start_ + off, start_ + old_size, finish_);
+                    return start_ + off;
+                }
+            }
+
+            iterator insert(const_iterator pos, std::initializer_list<T> init) {
+                return insert(pos, init.begin(), init.end());
+            }
+
+            // ׷ΧԤʱֻһ
+            template <std::ranges::input_range R>
+            void append_range(R&& rg) {
+                if constexpr (std::ranges::forward_range<R> || std::ranges::sized_range<R>) {
+                    size_type n = static_cast<size_type>(std::ranges::distance(rg));
+                    insert_n(finish_, n, [&](pointer dst) {
+                        std::ranges::uninitialized_copy_n(std::ranges::begin(rg), n, dst, dst + n);
+                    });
+                }
+                else {
+                    for (auto&& x : rg) {
+                        emplace_back(std::forward<decltype(x)>(x));
+                    }
+                }
+            }
+
+            // ɾԪأرɾһԪ֮λ
+            iterator erase(const_iterator pos) {
+                return erase(pos, pos + 1);
+            }
+
+            iterator erase(const_iterator first, const_iterator last) {
+                pointer p = start_ + (first - start_);
+                pointer q = start_ + (last - start_);
+                if (p == q) {
+                    return p;
+                }
+                if constexpr (is_trivially_relocatable_v<T>) {
+                    // ɾԪأٰβ尴ֽǰ
+                    for (pointer it = p; it != q; ++it) {
+                        allocator_.destroy(it);
+                    }
+                    std::memmove(static_cast<void*>(p), static_cast<const void*>(q), (finish_ - q) * sizeof(T));
+                    finish_ -= q - p;
+                }
+                else {
+                    pointer new_finish = std::move(q, finish_, p);
+                    for (pointer it = new_finish; it != finish_; ++it) {
+                        allocator_.destroy(it);
+                    }
+                    finish_ = new_finish;
+                }
+                return p;
+            }
+
+            // 滻ȫݣݳʱֱӷǡùõ¿飬
+            void assign(size_type n, const T& value) {
+                if (n > capacity()) {
+                    T tmp(value);
+                    clear();
+                    self().reallocate(n);
+                    finish_ = std::uninitialized_fill_n(start_, n, tmp);
+                    return;
+                }
+                if (n > size()) {
+                    std::fill(start_, finish_, value);
+                    finish_ = std::uninitialized_fill_n(finish_, n - size(), value);
+                }
+                else {
+                    std::fill_n(start_, n, value);
+                    destroy_tail(start_ + n);
+                }
+            }
+
+            template <std::input_iterator InputIt>
+            void assign(InputIt first, InputIt last) {
+                if constexpr (std::forward_iterator<InputIt>) {
+                    size_type n = std::distance(first, last);
+                    if (n > capacity()) {
+                        clear();
+                        self().reallocate(n);
+                        finish_ = std::uninitialized_copy(first, last, start_);
+                        return;
+                    }
+                    if (n > size()) {
+                        InputIt mid = std::next(first, size());
+                        std::copy(first, mid, start_);
+                        finish_ = std::uninitialized_copy(mid, last, finish_);
+                    }
+                    else {
+                        destroy_tail(std::copy(first, last, start_));
+                    }
+                }
+                else {
+                    clear();
+                    for (; first != last; ++first) {
+                        emplace_back(*first);
+                    }
+                }
+            }
+
+            void assign(std::initializer_list<T> init) {
+                assign(init.begin(), init.end());
+            }
+
+            // ıԪظԪֵʼint Ϊ 0
+            void resize(size_type n) {
+                if (n > size()) {
+                    if (n > capacity()) {
+                        self().reallocate(next_capacity(n));
+                    }
+                    finish_ = std::uninitialized_value_construct_n(finish_, n - size());
+                }
+                else {
+                    destroy_tail(start_ + n);
+                }
+            }
+
+            void resize(size_type n, const T& value) {
+                if (n > size()) {
+                    T tmp(value);
+                    if (n > capacity()) {
+                        self().reallocate(next_capacity(n));
+                    }
+                    finish_ = std::uninitialized_fill_n(finish_, n - size(), tmp);
+                }
+                else {
+                    destroy_tail(start_ + n);
+                }
+            }
+
+            //  resize ͬԪֻĬϳʼintƽͱδʼ
+            // ʺϽ帲дĻһأʡһ
+            void resize_for_overwrite(size_type n) {
+                if (n > size()) {
+                    if (n > capacity()) {
+                        self().reallocate(next_capacity(n));
+                    }
+                    finish_ = std::uninitialized_default_construct_n(finish_, n - size());
+                }
+                else {
+                    destroy_tail(start_ + n);
+                }
+            }
+
+        protected:
+            Derived& self() noexcept {
+                return static_cast<Derived&>(*this);
+            }
+
+            // Ӽ min_capacity Ԫص
+            size_type next_capacity(size_type min_capacity) const {
+                size_type cap = capacity();
+                size_type grown = cap + cap / Growth::den * (Growth::num - Growth::den)
+                    + cap % Growth::den * (Growth::num - Growth::den) / Growth::den;
+                return grown > min_capacity ? grown : min_capacity;
+            }
+
+            //  [new_finish, finish_)  finish_
+            void destroy_tail(pointer new_finish) {
+                for (pointer p = new_finish; p != finish_; ++p) {
+                    allocator_.destroy(p);
+                }
+                finish_ = new_finish;
+            }
+
+            //  pos ڳ n λã construct(dst)  dst ʼδʼڴһι n Ԫ
+            // construct ׳쳣ʱѹĲ֣صһԪصλ
+            template <typename Construct>
+            iterator insert_n(const_iterator pos, size_type n, Construct construct) {
+                size_type off = pos - start_;
+                if (n == 0) {
+                    return start_ + off;
+                }
+                size_type old_size = size();
+                if (n > max_size() - old_size) {
+                    throw std::length_error("vector::insert");
+                }
+
+                if constexpr (is_trivially_relocatable_v<T>) {
+                    size_type tail = old_size - off;
+                    if (n <= size_type(end_of_storage_ - finish_)) {
+                        // 㹻β memmove ƣճδʼڴ
+                        std::memmove(static_cast<void*>(start_ + off + n), static_cast<const void*>(start_ + off), tail * sizeof(T));
+                        try {
+                            construct(start_ + off);
+                        }
+                        catch (...) {
+                            std::memmove(static_cast<void*>(start_ + off), static_cast<const void*>(start_ + off + n), tail * sizeof(T));
+                            throw;
+                        }
+                    }
+                    else {
+                        // ¿ȹԪأٰǰηֱ memcpy ȥ
+                        size_type new_capacity = next_capacity(old_size + n);
+                        pointer new_start = allocator_.allocate(new_capacity);
+                        try {
+                            construct(new_start + off);
+                        }
+                        catch (...) {
+                            allocator_.deallocate(new_start, new_capacity);
+                            throw;
+                        }
+                        if (off) {
+                            std::memcpy(static_cast<void*>(new_start), static_cast<const void*>(start_), off * sizeof(T));
+                        }
+                        if (tail) {
+                            std::memcpy(static_cast<void*>(new_start + off + n), static_cast<const void*>(start_ + off), tail * sizeof(T));
+                        }
+                        self().release_storage();
+                        start_ = new_start;
+                        end_of_storage_ = new_start + new_capacity;
+                    }
+                    finish_ = start_ + old_size + n;
+                }
+                else {
+                    // һͣҪʱһݵλԪعĩβת pos
+                    if (n > size_type(end_of_storage_ - finish_)) {
+                        self().reallocate(next_capacity(old_size + n));
+                    }
+                    construct(finish_);
+                    finish_ += n;
+                    std::rotate(start_ + off, start_ + old_size, finish_);
+                }
+                return start_ + off;
+            }
+
+            // ʱ emplace_backñڵԪأȹ쵽ʱ
+            template <typename... Args>
+            reference emplace_back_grow(Args&&... args) {
+                T tmp(std::forward<Args>(args)...);
+                self().reallocate(next_capacity(size() + 1));
+                allocator_.construct(finish_, std::move(tmp));
+                ++finish_;
+                return back();
+            }
+        };
+
+    } // namespace detail
+
+    template <typename T, typename Alloc = allocator<T>, typename Growth = growth_factor<3, 2>>
+    class vector : public detail::vector_base<vector<T, Alloc, Growth>, T, Alloc, Growth> {
+        using base = detail::vector_base<vector, T, Alloc, Growth>;
+        friend base;
+
     public:
         // Ͷ
-        using value_type = T;
-        using allocator_type = Alloc;
-        using size_type = typename std::allocator_traits<Alloc>::size_type;
-        using difference_type = typename std::allocator_traits<Alloc>::difference_type;
-        using reference = value_type&;
-        using const_reference = const value_type&;
-        using pointer = typename std::allocator_traits<Alloc>::pointer;
-        using const_pointer = typename std::allocator_traits<Alloc>::const_pointer;
-        using iterator = pointer;  // ʵָ֣Ϊ
-        using const_iterator = const_pointer;
+        using typename base::value_type;
+        using typename base::allocator_type;
+        using typename base::size_type;
+        using typename base::difference_type;
+        using typename base::reference;
+        using typename base::const_reference;
+        using typename base::pointer;
+        using typename base::const_pointer;
+        using typename base::iterator;
+        using typename base::const_iterator;
 
     private:
-        pointer start_ = nullptr;      // ָһԪ
-        pointer finish_ = nullptr;     // ָһԪصһλ
-        pointer end_of_storage_ = nullptr; // ָڴĩβ
-        [[no_unique_address]] Alloc allocator_; // 
+        using base::start_;
+        using base::finish_;
+        using base::end_of_storage_;
+        using base::allocator_;
 
     public:
+        using base::size;
+        using base::capacity;
+        using base::max_size;
+        using base::empty;
+        using base::clear;
+
         // ĬϹ캯
-        vector() noexcept(noexcept(Alloc())) : allocator_() {}
+        vector() noexcept(noexcept(Alloc())) = default;
 
         // ָĹ캯
-        explicit vector(const Alloc& alloc) noexcept : allocator_(alloc) {}
+        explicit vector(const Alloc& alloc) noexcept : base(alloc) {}
 
         // ָСͳʼֵĹ캯
         explicit vector(size_type n, const T& value = T(), const Alloc& alloc = Alloc())
-            : allocator_(alloc) {
+            : base(alloc) {
             start_ = allocator_.allocate(n);
             finish_ = start_ + n;
             end_of_storage_ = finish_;
             std::uninitialized_fill(start_, finish_, value);
         }
 
-        // Χ캯
-        template <typename InputIt>
+        // Χ캯ԼΪvector<int>(5, 3) ѡ
+        template <std::input_iterator InputIt>
         vector(InputIt first, InputIt last, const Alloc& alloc = Alloc())
-            : allocator_(alloc) {
-            // 
-            size_type n = std::distance(first, last);
-            start_ = allocator_.allocate(n);
-            finish_ = start_ + n;
-            end_of_storage_ = finish_;
-            std::uninitialized_copy(first, last, start_);
+            : base(alloc) {
+            if constexpr (std::forward_iterator<InputIt>) {
+                // 
+                size_type n = std::distance(first, last);
+                start_ = allocator_.allocate(n);
+                finish_ = start_ + n;
+                end_of_storage_ = finish_;
+                std::uninitialized_copy(first, last, start_);
+            }
+            else {
+                // ˵޷Ԥ󳤶ȣ׷
+                for (; first != last; ++first) {
+                    this->emplace_back(*first);
+                }
+            }
         }
 
         // ʼб캯
@@ -63,12 +513,12 @@ namespace mystl {
         // 
         ~vector() {
             clear();
-            allocator_.deallocate(start_, capacity());
+            release_storage();
         }
 
         // 캯
         vector(const vector& other)
-            : allocator_(std::allocator_traits<Alloc>::select_on_container_copy_construction(
+            : base(std::allocator_traits<Alloc>::select_on_container_copy_construction(
                 other.allocator_)) {
             size_type n = other.size();
             start_ = allocator_.allocate(n);
@@ -79,10 +529,10 @@ namespace mystl {
 
         // ƶ캯
         vector(vector&& other) noexcept
-            : start_(other.start_),
-            finish_(other.finish_),
-            end_of_storage_(other.end_of_storage_),
-            allocator_(std::move(other.allocator_)) {
+            : base(std::move(other.allocator_)) {
+            start_ = other.start_;
+            finish_ = other.finish_;
+            end_of_storage_ = other.end_of_storage_;
             other.start_ = other.finish_ = other.end_of_storage_ = nullptr;
         }
 
@@ -96,7 +546,7 @@ namespace mystl {
 
                 // ͷžڴ
                 clear();
-                allocator_.deallocate(start_, capacity());
+                release_storage();
 
                 // ָ
                 start_ = new_start;
@@ -111,7 +561,7 @@ namespace mystl {
             if (this != &other) {
                 // ͷŵǰԴ
                 clear();
-                allocator_.deallocate(start_, capacity());
+                release_storage();
 
                 // ӹotherԴ
                 start_ = other.start_;
@@ -125,15 +575,6 @@ namespace mystl {
             return *this;
         }
 
-        // Ԫط
-        reference operator[](size_type pos) {
-            return start_[pos];
-        }
-
-        const_reference operator[](size_type pos) const {
-            return start_[pos];
-        }
-
         reference at(size_type pos) {
             if (pos >= size()) {
                 throw std::out_of_range("vector::at");
@@ -148,104 +589,66 @@ namespace mystl {
             return start_[pos];
         }
 
-        reference front() {
-            return *start_;
-        }
-
-        const_reference front() const {
-            return *start_;
-        }
-
-        reference back() {
-            return *(finish_ - 1);
-        }
-
-        const_reference back() const {
-            return *(finish_ - 1);
-        }
-
-        pointer data() noexcept {
-            return start_;
-        }
-
-        const_pointer data() const noexcept {
-            return start_;
-        }
-
-        // 
-        iterator begin() noexcept {
-            return start_;
-        }
-
-        const_iterator begin() const noexcept {
-            return start_;
-        }
-
-        iterator end() noexcept {
-            return finish_;
-        }
-
-        const_iterator end() const noexcept {
-            return finish_;
-        }
-
-        // 
-        bool empty() const noexcept {
-            return start_ == finish_;
-        }
-
-        size_type size() const noexcept {
-            return finish_ - start_;
-        }
-
-        size_type capacity() const noexcept {
-            return end_of_storage_ - start_;
-        }
-
-        // ޸
-        void clear() {
-            if (start_) {
-                for (pointer p = start_; p != finish_; ++p) {
-                    allocator_.destroy(p);
-                }
-                finish_ = start_;
+        // Ԥ n Ԫصֻһ
+        void reserve(size_type n) {
+            if (n > max_size()) {
+                throw std::length_error("vector::reserve");
             }
-        }
-
-        void push_back(const T& value) {
-            if (finish_ == end_of_storage_) {
-                reallocate(size() ? size() * 2 : 1);
+            if (n > capacity()) {
+                reallocate(n);
             }
-            allocator_.construct(finish_, value);
-            ++finish_;
         }
 
-        void push_back(T&& value) {
+        //  size()ƽضλԪؾ realloc ԭ
+        void shrink_to_fit() {
             if (finish_ == end_of_storage_) {
-                reallocate(size() ? size() * 2 : 1);
+                return;
             }
-            allocator_.construct(finish_, std::move(value));
-            ++finish_;
-        }
-
-        template <typename... Args>
-        reference emplace_back(Args&&... args) {
-            if (finish_ == end_of_storage_) {
-                reallocate(size() ? size() * 2 : 1);
+            if (empty()) {
+                release_storage();
+                start_ = finish_ = end_of_storage_ = nullptr;
+                return;
             }
-            allocator_.construct(finish_, std::forward<Args>(args)...);
-            ++finish_;
-            return back();
+            reallocate(size());
         }
 
-        void pop_back() {
-            --finish_;
-            allocator_.destroy(finish_);
+        void swap(vector& other) noexcept {
+            std::swap(start_, other.start_);
+            std::swap(finish_, other.finish_);
+            std::swap(end_of_storage_, other.end_of_storage_);
+            std::swap(allocator_, other.allocator_);
         }
 
     private:
+        // ͷŴ洢Ԫأ
+        void release_storage() noexcept {
+            allocator_.deallocate(start_, capacity());
+        }
+
         // ·ڴ
         void reallocate(size_type new_capacity) {
+            if constexpr (is_trivially_relocatable_v<T>) {
+                // Ԫؿ԰ֽڰᶯ֧ reallocate ʱ reallocԭչ
+                // ¿ memcpyɿԪزҪ
+                size_type n = size();
+                pointer new_start;
+                if constexpr (requires(Alloc& a, pointer p, size_type k) { a.reallocate(p, k, k); }) {
+                    new_start = start_ ? allocator_.reallocate(start_, capacity(), new_capacity)
+                                       : allocator_.allocate(new_capacity);
+                }
+                else {
+                    new_start = allocator_.allocate(new_capacity);
+                    if (n) {
+                        std::memcpy(static_cast<void*>(new_start), static_cast<const void*>(start_), n * sizeof(T));
+                    }
+                    release_storage();
+                }
+                start_ = new_start;
+                finish_ = start_ + n;
+                end_of_storage_ = start_ + new_capacity;
+                return;
+            }
+
             // ڴ
             pointer new_start = allocator_.allocate(new_capacity);
             pointer new_finish = new_start;
@@ -262,7 +665,7 @@ namespace mystl {
 
             // ٲͷžڴ
             clear();
-            allocator_.deallocate(start_, capacity());
+            release_storage();
 
             // ָ
             start_ = new_start;
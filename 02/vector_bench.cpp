@@ -0,0 +1,84 @@
+// vector ׼ԣ push_back ĺʱԱ std::vector  mystl::vector  2 1.5 
+// int Сṹǿƽضλģmystl::vector ʱ reallocstd::string Ϊƶ
+// Уvector_bench [Ԫظ]Ĭ 100000000std::string ֻʮ֮һ
+
+#include "vector.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+struct Point3 {
+    int x, y, z;
+};
+
+template <typename T>
+using vector_2x = mystl::vector<T, mystl::allocator<T>, mystl::growth_factor<2, 1>>;
+
+template <typename T>
+using vector_15x = mystl::vector<T, mystl::allocator<T>, mystl::growth_factor<3, 2>>;
+
+template <typename T>
+T make_value(std::size_t i);
+
+template <>
+int make_value<int>(std::size_t i) {
+    return static_cast<int>(i);
+}
+
+template <>
+Point3 make_value<Point3>(std::size_t i) {
+    int v = static_cast<int>(i);
+    return Point3{ v, v + 1, v + 2 };
+}
+
+template <>
+std::string make_value<std::string>(std::size_t i) {
+    return std::string(1 + i % 15, 'a');
+}
+
+//  push_back n Ԫصĺʱ룩ȡ rounds еСֵ
+template <typename Vec>
+double time_push_back(std::size_t n, int rounds) {
+    using T = typename Vec::value_type;
+    double best = 1e300;
+    for (int r = 0; r < rounds; ++r) {
+        auto start = Clock::now();
+        {
+            Vec v;
+            for (std::size_t i = 0; i < n; ++i) v.push_back(make_value<T>(i));
+            if (v.size() != n) std::abort();
+        }
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        if (ms < best) best = ms;
+    }
+    return best;
+}
+
+template <typename T>
+void run(const char* name, std::size_t n, int rounds) {
+    double t_std = time_push_back<std::vector<T>>(n, rounds);
+    double t_2x = time_push_back<vector_2x<T>>(n, rounds);
+    double t_15x = time_push_back<vector_15x<T>>(n, rounds);
+    std::cout << std::left << std::setw(14) << name << std::right << std::setw(12) << n
+              << std::fixed << std::setprecision(1)
+              << std::setw(14) << t_std << std::setw(14) << t_2x << std::setw(14) << t_15x << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000;
+    const int rounds = 3;
+
+    std::cout << "push_back, best of " << rounds << " rounds (ms, including destruction)\n\n";
+    std::cout << std::left << std::setw(14) << "element" << std::right << std::setw(12) << "count"
+              << std::setw(14) << "std::vector" << std::setw(14) << "mystl 2x" << std::setw(14) << "mystl 1.5x" << "\n";
+    run<int>("int", n, rounds);
+    run<Point3>("Point3", n, rounds);
+    run<std::string>("std::string", n / 10, rounds);
+    return 0;
+}
\ No newline at end of file
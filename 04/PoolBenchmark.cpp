@@ -0,0 +1,271 @@
+/******************************
+*   author: yuesong-feng
+*
+*
+*
+******************************/
+// 线程池基准测试：01/ThreadPool.h 的三种调度模式与本目录 src/ThreadPool.cpp（无界/有界队列）对比
+//   empty   外部线程连续提交空任务的吞吐
+//   fanout  一次扇出若干小任务再全部汇合，单轮延迟的p50/p99
+//   nested  任务在工作线程内部继续提交子任务的吞吐
+//   contend 1..N个生产者线程同时提交的总吞吐
+// 线程池的线程数从1按2的倍数扫到给定的最大值，每个线程数打印一张表；加 --json 文件名 时另外写一份JSON
+// 两边的线程池都直接编进来：本目录的在netpool命名空间里，与01的同名类型不冲突
+// 编译：make bench，运行：./PoolBenchmark [最大线程数] [--json bench.json]
+
+#include "src/ThreadPool.h"
+#include "../01/ThreadPool.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+
+typedef std::chrono::steady_clock BenchClock;
+
+static double secondsSince(BenchClock::time_point start){
+    return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+// 计数归零时唤醒等待方；每一轮开始前reset
+class Countdown
+{
+private:
+    std::atomic<size_t> left;
+    std::atomic<bool> done;
+public:
+    Countdown() : left(0), done(false) {}
+    void reset(size_t n){
+        done = false;
+        left = n;
+    }
+    void arrive(){
+        if(left.fetch_sub(1, std::memory_order_acq_rel) == 1){
+            done.store(true, std::memory_order_release);
+            done.notify_one();
+        }
+    }
+    void wait(){
+        done.wait(false, std::memory_order_acquire);
+    }
+};
+
+// 被测线程池的统一接口：各自最便宜的"提交后不关心结果"的方式
+class Pool01
+{
+private:
+    ThreadPool pool;
+public:
+    Pool01(size_t threads, SchedulingMode mode) : pool(ThreadPoolOptions{ threads, mode }) {}
+    template<class F>
+    void post(F&& f){ pool.post(std::forward<F>(f)); }
+};
+
+class Pool04
+{
+private:
+    netpool::ThreadPool pool;
+public:
+    Pool04(size_t threads, size_t capacity) : pool(static_cast<int>(threads), netpool::Placement::NONE, capacity) {}
+    template<class F>
+    void post(F&& f){ pool.submitDetached(std::forward<F>(f)); }
+};
+
+struct Result {
+    double emptyRate;                   // 任务/秒
+    double fanoutP50, fanoutP99;        // 微秒
+    double nestedRate;
+    std::vector<double> contendRate;    // 下标i对应 producers[i] 个生产者
+};
+
+struct Config {
+    size_t threads;
+    size_t emptyTasks;
+    size_t fanoutWidth, fanoutRounds;
+    size_t nestedRoots, nestedLeaves;
+    size_t contendTasks;                // 所有生产者合计提交的任务数
+    std::vector<size_t> producers;
+};
+
+template<class Pool>
+double benchEmpty(Pool &pool, const Config &cfg){
+    Countdown cd;
+    cd.reset(cfg.emptyTasks);
+    BenchClock::time_point start = BenchClock::now();
+    for(size_t i = 0; i < cfg.emptyTasks; ++i)
+        pool.post([&cd](){ cd.arrive(); });
+    cd.wait();
+    return cfg.emptyTasks / secondsSince(start);
+}
+
+template<class Pool>
+void benchFanout(Pool &pool, const Config &cfg, double &p50, double &p99){
+    std::vector<double> samples(cfg.fanoutRounds);
+    Countdown cd;
+    for(size_t r = 0; r < cfg.fanoutRounds; ++r){
+        cd.reset(cfg.fanoutWidth);
+        BenchClock::time_point start = BenchClock::now();
+        for(size_t i = 0; i < cfg.fanoutWidth; ++i)
+            pool.post([&cd](){ cd.arrive(); });
+        cd.wait();
+        samples[r] = std::chrono::duration<double, std::micro>(BenchClock::now() - start).count();
+    }
+    std::sort(samples.begin(), samples.end());
+    p50 = samples[samples.size() / 2];
+    p99 = samples[samples.size() * 99 / 100];
+}
+
+template<class Pool>
+double benchNested(Pool &pool, const Config &cfg){
+    Countdown cd;
+    cd.reset(cfg.nestedRoots * cfg.nestedLeaves);
+    size_t leaves = cfg.nestedLeaves;
+    BenchClock::time_point start = BenchClock::now();
+    for(size_t i = 0; i < cfg.nestedRoots; ++i){
+        pool.post([&pool, &cd, leaves](){
+            for(size_t j = 0; j < leaves; ++j)
+                pool.post([&cd](){ cd.arrive(); });
+        });
+    }
+    cd.wait();
+    return cfg.nestedRoots * cfg.nestedLeaves / secondsSince(start);
+}
+
+template<class Pool>
+double benchContend(Pool &pool, size_t producers, size_t total){
+    size_t each = total / producers;
+    Countdown cd;
+    cd.reset(each * producers);
+    std::atomic<bool> go(false);
+    std::vector<std::thread> threads;
+    for(size_t p = 0; p < producers; ++p){
+        threads.emplace_back([&pool, &cd, &go, each](){
+            while(!go.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            for(size_t i = 0; i < each; ++i)
+                pool.post([&cd](){ cd.arrive(); });
+        });
+    }
+    BenchClock::time_point start = BenchClock::now();
+    go.store(true, std::memory_order_release);
+    cd.wait();
+    double rate = each * producers / secondsSince(start);
+    for(std::thread &t : threads)
+        t.join();
+    return rate;
+}
+
+// 每个场景新建一个线程池，上一个场景残留的状态（队列容量、休眠的线程）不影响下一个
+template<class Pool, class... A>
+Result runAll(const Config &cfg, A... args){
+    Result r;
+    { Pool pool(cfg.threads, args...); r.emptyRate = benchEmpty(pool, cfg); }
+    { Pool pool(cfg.threads, args...); benchFanout(pool, cfg, r.fanoutP50, r.fanoutP99); }
+    { Pool pool(cfg.threads, args...); r.nestedRate = benchNested(pool, cfg); }
+    for(size_t p : cfg.producers){
+        Pool pool(cfg.threads, args...);
+        r.contendRate.push_back(benchContend(pool, p, cfg.contendTasks));
+    }
+    return r;
+}
+
+static void printTable(const Config &cfg, const std::vector<std::string> &names, const std::vector<Result> &results){
+    std::cout << "threads: " << cfg.threads << "\n\n";
+    std::cout << std::left << std::setw(18) << "backend" << std::right
+              << std::setw(14) << "empty(M/s)" << std::setw(14) << "fanout p50" << std::setw(14) << "fanout p99"
+              << std::setw(14) << "nested(M/s)" << "\n";
+    for(size_t i = 0; i < results.size(); ++i){
+        const Result &r = results[i];
+        std::cout << std::left << std::setw(18) << names[i] << std::right << std::fixed
+                  << std::setprecision(3) << std::setw(14) << r.emptyRate / 1e6
+                  << std::setprecision(1) << std::setw(12) << r.fanoutP50 << "us" << std::setw(12) << r.fanoutP99 << "us"
+                  << std::setprecision(3) << std::setw(14) << r.nestedRate / 1e6 << "\n";
+    }
+    std::cout << "\nfanout: " << cfg.fanoutWidth << " tasks per round; contended producers (M tasks/s):\n";
+    std::cout << std::left << std::setw(18) << "backend" << std::right;
+    for(size_t p : cfg.producers)
+        std::cout << std::setw(12) << ("P=" + std::to_string(p));
+    std::cout << "\n";
+    for(size_t i = 0; i < results.size(); ++i){
+        std::cout << std::left << std::setw(18) << names[i] << std::right << std::fixed << std::setprecision(3);
+        for(double rate : results[i].contendRate)
+            std::cout << std::setw(12) << rate / 1e6;
+        std::cout << "\n";
+    }
+}
+
+static void writeJson(std::ostream &os, const Config &cfg, const std::vector<std::string> &names, const std::vector<Result> &results){
+    os << "    {\"threads\": " << cfg.threads << ", \"results\": [";
+    for(size_t i = 0; i < results.size(); ++i){
+        const Result &r = results[i];
+        os << (i ? "," : "") << "\n      {\"backend\": \"" << names[i] << "\""
+           << ", \"empty_tasks_per_sec\": " << r.emptyRate
+           << ", \"fanout_width\": " << cfg.fanoutWidth
+           << ", \"fanout_p50_us\": " << r.fanoutP50
+           << ", \"fanout_p99_us\": " << r.fanoutP99
+           << ", \"nested_tasks_per_sec\": " << r.nestedRate
+           << ", \"contended\": [";
+        for(size_t j = 0; j < cfg.producers.size(); ++j){
+            os << (j ? ", " : "") << "{\"producers\": " << cfg.producers[j]
+               << ", \"tasks_per_sec\": " << r.contendRate[j] << "}";
+        }
+        os << "]}";
+    }
+    os << "\n    ]}";
+}
+
+int main(int argc, char *argv[]){
+    Config cfg;
+    size_t maxThreads = std::thread::hardware_concurrency();
+    std::string jsonPath;
+    for(int i = 1; i < argc; ++i){
+        std::string arg = argv[i];
+        if(arg == "--json" && i + 1 < argc)
+            jsonPath = argv[++i];
+        else
+            maxThreads = std::stoul(arg);
+    }
+    if(maxThreads == 0)
+        maxThreads = 1;
+
+    cfg.emptyTasks = 200000;
+    cfg.fanoutWidth = 64;
+    cfg.fanoutRounds = 2000;
+    cfg.nestedRoots = 64;
+    cfg.nestedLeaves = 2000;
+    cfg.contendTasks = 200000;
+    //生产者数在各个线程数下保持一致，表格之间可以直接对比
+    size_t maxProducers = std::max<size_t>(maxThreads, 4);
+    for(size_t p = 1; p <= maxProducers; p *= 2)
+        cfg.producers.push_back(p);
+
+    std::vector<size_t> threadCounts;
+    for(size_t t = 1; t < maxThreads; t *= 2)
+        threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    const std::vector<std::string> names = {
+        "01/shared-queue", "01/work-stealing", "01/bounded-mpmc", "04/unbounded", "04/bounded-mpmc"
+    };
+    std::ostringstream json;
+    for(size_t k = 0; k < threadCounts.size(); ++k){
+        cfg.threads = threadCounts[k];
+        std::vector<Result> results;
+        results.push_back(runAll<Pool01>(cfg, SchedulingMode::SharedQueue));
+        results.push_back(runAll<Pool01>(cfg, SchedulingMode::WorkStealing));
+        results.push_back(runAll<Pool01>(cfg, SchedulingMode::BoundedQueue));
+        results.push_back(runAll<Pool04>(cfg, size_t(0)));
+        results.push_back(runAll<Pool04>(cfg, size_t(1024)));
+
+        if(k)
+            std::cout << "\n";
+        printTable(cfg, names, results);
+        json << (k ? ",\n" : "");
+        writeJson(json, cfg, names, results);
+    }
+    if(!jsonPath.empty()){
+        std::ofstream out(jsonPath.c_str());
+        out << "{\n  \"runs\": [\n" << json.str() << "\n  ]\n}\n";
+        std::cout << "\njson written to " << jsonPath << "\n";
+    }
+    return 0;
+}
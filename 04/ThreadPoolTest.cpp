@@ -12,7 +12,7 @@ void test(){
 
 int main(int argc, char const *argv[])
 {
-    ThreadPool *poll = new ThreadPool();
+    netpool::ThreadPool *poll = new netpool::ThreadPool();
     std::function<void()> func = std::bind(print, 1, 3.14, "hello", std::string("world"));
     poll->add(func);
     func = test;
@@ -23,13 +23,13 @@ Channel::~Channel(){
 void Channel::handleEvent(){
     if(ready & (EPOLLIN | EPOLLPRI)){
         if(useThreadPool)       
-            loop->addThread(readCallback);
+            loop->addThread(netpool::Task(readCallback));
         else
             readCallback();
     }
     if(ready & (EPOLLOUT)){
         if(useThreadPool)       
-            loop->addThread(writeCallback);
+            loop->addThread(netpool::Task(writeCallback));
         else
             writeCallback();
     }
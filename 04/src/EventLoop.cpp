@@ -12,7 +12,7 @@
 
 EventLoop::EventLoop() : ep(nullptr), threadPool(nullptr), quit(false){
     ep = new Epoll();
-    threadPool = new ThreadPool();
+    threadPool = new netpool::ThreadPool();
 }
 
 EventLoop::~EventLoop(){
@@ -35,6 +35,6 @@ void EventLoop::updateChannel(Channel *ch){
     ep->updateChannel(ch);
 }
 
-void EventLoop::addThread(std::function<void()> func){
-    threadPool->add(func);
+void EventLoop::addThread(netpool::Task func){
+    threadPool->submitDetached(std::move(func));
 }
\ No newline at end of file
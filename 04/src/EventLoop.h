@@ -12,15 +12,16 @@
 ******************************/
 #pragma once
 #include <functional>
+#include "Task.h"
 
 class Epoll;
 class Channel;
-class ThreadPool;
+namespace netpool { class ThreadPool; }
 class EventLoop
 {
 private:
     Epoll *ep;
-    ThreadPool *threadPool;
+    netpool::ThreadPool *threadPool;
     bool quit;
 public:
     EventLoop();
@@ -29,6 +30,6 @@ public:
     void loop();
     void updateChannel(Channel*);
 
-    void addThread(std::function<void()>);
+    void addThread(netpool::Task);
 };
 
@@ -0,0 +1,98 @@
+/******************************
+*   author: yuesong-feng
+*   
+*
+*
+******************************/
+#pragma once
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <utility>
+
+namespace netpool {
+
+// 有界多生产者多消费者环形队列（Vyukov）：每个槽位一个序号，生产者/消费者各用一次CAS抢位置，
+// 读写槽位不加锁。容量构造时固定（向上取整到2的幂），满了tryPush返回false
+template<class T>
+class MpmcQueue
+{
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    //生产者、消费者游标之间用填充隔开，不落在同一条缓存行上。
+    //C++11的new不保证超过16字节的对齐，所以用填充而不是alignas(64)
+    char pad0[64];
+    std::atomic<size_t> enqueuePos;
+    char pad1[64 - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> dequeuePos;
+    char pad2[64 - sizeof(std::atomic<size_t>)];
+    size_t mask;
+    std::unique_ptr<Cell[]> cells;
+
+public:
+    explicit MpmcQueue(size_t capacity) : enqueuePos(0), dequeuePos(0){
+        size_t n = 2;
+        while(n < capacity) n <<= 1;
+        mask = n - 1;
+        cells.reset(new Cell[n]);
+        for(size_t i = 0; i < n; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    //成功时移走value，队列满时value不变
+    bool tryPush(T &value){
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        while(true){
+            Cell &cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if(diff == 0){
+                if(enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+                    cell.data = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if(diff < 0){
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPop(T &value){
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        while(true){
+            Cell &cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if(diff == 0){
+                if(dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+                    value = std::move(cell.data);
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if(diff < 0){
+                return false;
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+    size_t sizeApprox() const {
+        size_t tail = enqueuePos.load(std::memory_order_acquire);
+        size_t head = dequeuePos.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+};
+
+} // namespace netpool
@@ -0,0 +1,110 @@
+/******************************
+*   author: yuesong-feng
+*
+*
+*
+******************************/
+#pragma once
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+namespace netpool {
+
+// 只可移动的任务类型，替代std::function<void()>：可以直接装下std::packaged_task这类不可复制的对象。
+// 不超过48字节、移动构造不抛异常的可调用对象放在内部缓冲区里，不产生堆分配
+class Task
+{
+public:
+    static constexpr size_t INLINE_SIZE = 48;
+
+    Task() noexcept : ops(nullptr) {}
+
+    template<class F, class Fn = std::decay_t<F>,
+             class = std::enable_if_t<!std::is_same<Fn, Task>::value && std::is_invocable<Fn&>::value> >
+    Task(F&& f) : ops(nullptr) {
+        if constexpr (fitsInline<Fn>()) {
+            ::new (static_cast<void*>(storage)) Fn(std::forward<F>(f));
+            ops = &inlineOps<Fn>;
+        } else {
+            ::new (static_cast<void*>(storage)) Fn*(new Fn(std::forward<F>(f)));
+            ops = &heapOps<Fn>;
+        }
+    }
+
+    Task(Task &&other) noexcept : ops(other.ops) {
+        if(ops){
+            ops->move(storage, other.storage);
+            other.ops = nullptr;
+        }
+    }
+
+    Task &operator=(Task &&other) noexcept {
+        if(this != &other){
+            reset();
+            if(other.ops){
+                other.ops->move(storage, other.storage);
+                ops = other.ops;
+                other.ops = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task &operator=(const Task&) = delete;
+
+    ~Task() { reset(); }
+
+    void operator()() { ops->invoke(storage); }
+    explicit operator bool() const noexcept { return ops != nullptr; }
+
+private:
+    // 类型擦除后的操作表，每种可调用类型一份
+    struct Ops {
+        void (*invoke)(void*);
+        void (*move)(void *dst, void *src) noexcept;    //移动到dst并销毁src
+        void (*destroy)(void*) noexcept;
+    };
+
+    template<class Fn>
+    static constexpr bool fitsInline() {
+        return sizeof(Fn) <= INLINE_SIZE && alignof(Fn) <= alignof(std::max_align_t)
+            && std::is_nothrow_move_constructible<Fn>::value;
+    }
+
+    template<class Fn>
+    static void invokeInline(void *p) { (*static_cast<Fn*>(p))(); }
+    template<class Fn>
+    static void moveInline(void *dst, void *src) noexcept {
+        ::new (dst) Fn(std::move(*static_cast<Fn*>(src)));
+        static_cast<Fn*>(src)->~Fn();
+    }
+    template<class Fn>
+    static void destroyInline(void *p) noexcept { static_cast<Fn*>(p)->~Fn(); }
+
+    template<class Fn>
+    static void invokeHeap(void *p) { (**static_cast<Fn**>(p))(); }
+    template<class Fn>
+    static void moveHeap(void *dst, void *src) noexcept { ::new (dst) Fn*(*static_cast<Fn**>(src)); }
+    template<class Fn>
+    static void destroyHeap(void *p) noexcept { delete *static_cast<Fn**>(p); }
+
+    template<class Fn>
+    static constexpr Ops inlineOps = { &invokeInline<Fn>, &moveInline<Fn>, &destroyInline<Fn> };
+    template<class Fn>
+    static constexpr Ops heapOps = { &invokeHeap<Fn>, &moveHeap<Fn>, &destroyHeap<Fn> };
+
+    void reset() noexcept {
+        if(ops){
+            ops->destroy(storage);
+            ops = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char storage[INLINE_SIZE];
+    const Ops *ops;
+};
+
+} // namespace netpool
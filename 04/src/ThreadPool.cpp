@@ -5,36 +5,553 @@
 *
 ******************************/
 #include "ThreadPool.h"
+#include <algorithm>
 
-ThreadPool::ThreadPool(int size) : stop(false){
-    for(int i = 0; i < size; ++i){
-        threads.emplace_back(std::thread([this](){
-            while(true){
-                std::function<void()> task;
-                {
-                    std::unique_lock<std::mutex> lock(tasks_mtx);
-                    cv.wait(lock, [this](){
-                        return stop || !tasks.empty();
-                    });
-                    if(stop && tasks.empty()) return;
-                    task = tasks.front();
-                    tasks.pop();
+namespace netpool {
+
+thread_local ThreadPool *ThreadPool::current = nullptr;
+thread_local ThreadPool::LocalQueue *ThreadPool::currentLocal = nullptr;
+
+ThreadPool::ThreadPool(int size, Placement placement, size_t queueCapacity, Backpressure policy,
+                       const std::vector<int> &cpuSet)
+    : starvationLimit(16), pending(0), nodePending(0), spinCount(0), yieldCount(0), idle(0),
+      coreSize(size), maxSize(size), growThreshold(8), idleTimeout(1000), live(size), stop(false),
+      localPending(0), backpressure(policy), ringPending(0), highPending(0), blockedProducers(0), timerDropped(0){
+    if(queueCapacity > 0)
+        ring.reset(new MpmcQueue<Task>(queueCapacity));
+    for(int l = 0; l < LANES; ++l){
+        laneSkips[l] = 0;
+        expired[l] = 0;
+        for(int b = 0; b < BUCKETS; ++b)
+            waitHist[l][b] = 0;
+    }
+
+    //先算好每个线程的CPU集合和节点，线程启动后各自绑定
+    std::vector<std::vector<int> > threadCpus(size);
+    threadNode.assign(size, 0);
+    if(placement != Placement::NONE){
+        topology = CpuTopology::detect();
+        nodeQueues.resize(topology.nodeCount());
+        const std::vector<int> &pinned = cpuSet.empty() ? topology.cpus : cpuSet;
+        for(int i = 0; i < size; ++i){
+            if(placement == Placement::SPREAD_NODES){
+                threadNode[i] = i % topology.nodeCount();
+                threadCpus[i] = topology.nodes[threadNode[i]];
+            } else {
+                int cpu = pinned[i % pinned.size()];
+                threadCpus[i].push_back(cpu);
+                for(int n = 0; n < topology.nodeCount(); ++n){
+                    if(std::find(topology.nodes[n].begin(), topology.nodes[n].end(), cpu) != topology.nodes[n].end())
+                        threadNode[i] = n;
                 }
-                task();
             }
+        }
+    }
+
+    slotActive.assign(size, true);
+    for(int i = 0; i < size; ++i)
+        localQueues.push_back(std::unique_ptr<LocalQueue>(new LocalQueue()));
+    for(int i = 0; i < size; ++i){
+        std::vector<int> cpus = threadCpus[i];
+        int node = nodeQueues.empty() ? -1 : threadNode[i];
+        threads.emplace_back(std::thread([this, i, node, cpus](){
+            CpuTopology::pinCurrentThread(cpus);
+            worker(i, node);
         }));
     }
 }
 
+static inline void cpuRelax(){
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+//node为-1表示不服务任何节点队列（弹性扩出来的线程）
+void ThreadPool::worker(int id, int node){
+    current = this;
+    {
+        std::unique_lock<std::mutex> lock(tasks_mtx);   //setElastic可能同时在扩大localQueues
+        currentLocal = localQueues[id].get();
+    }
+    std::deque<Item> *mine = node < 0 ? nullptr : &nodeQueues[node];
+    bool elastic = id >= coreSize;
+    auto ready = [this, mine](){
+        return stop || pending > 0 || (mine && !mine->empty()) || ringPending > 0 || localPending > 0;
+    };
+    int ringStreak = 0, localStreak = 0;
+    std::vector<LocalQueue*> victims;   //窃取前在tasks_mtx下记下各个本地缓冲，放锁后再去取
+    while(true){
+        Item item;
+        bool isExpired;
+        bool stealing = false;
+
+        //本线程add的后续任务在自己的本地缓冲里，取的时候不碰tasks_mtx
+        Task fast;
+        if(localStreak < LOCAL_BATCH && popLocal(fast)){
+            ++localStreak;
+            fast();
+            continue;
+        }
+        localStreak = 0;
+
+        //先不加锁地自旋、yield，看到任务（可能是别的节点的，无妨）就去取
+        int spins = spinCount, yields = yieldCount;
+        for(int i = 0; i < spins + yields; ++i){
+            if(stop || pending > 0 || nodePending > 0 || ringPending > 0 || localPending > 0) break;
+            if(i < spins) cpuRelax();
+            else std::this_thread::yield();
+        }
+
+        //有界队列里都是NORMAL任务，不加锁直接取；HIGH队列有任务时让它先走，
+        //并且每取RING_BATCH个就去加锁的队列看一次，免得LOW和定向任务饿死
+        if(ring && highPending == 0 && ringStreak < RING_BATCH && popRing(fast)){
+            ++ringStreak;
+            fast();
+            continue;
+        }
+        ringStreak = 0;
+
+        {
+            std::unique_lock<std::mutex> lock(tasks_mtx);
+            if(!ready()){
+                //持锁登记idle，提交方据此决定是否需要notify
+                ++idle;
+                bool woken = true;
+                if(elastic) woken = cv.wait_for(lock, idleTimeout, ready);
+                else cv.wait(lock, ready);
+                --idle;
+                if(!woken){
+                    slotActive[id] = false;    //空闲超时，让出槽位
+                    --live;
+                    return;
+                }
+            }
+            if(stop && pending == 0 && (!mine || mine->empty()) && ringPending == 0 && localPending == 0) return;
+            if(mine && !mine->empty()){
+                //定向到本节点的任务优先
+                item = std::move(mine->front());
+                mine->pop_front();
+                --nodePending;
+            } else if(!popNext(item)){
+                //加锁的队列都空了，任务在有界队列或别的线程的本地缓冲里
+                if(localPending == 0) continue;
+                victims.clear();
+                for(size_t i = 0; i < localQueues.size(); ++i)
+                    victims.push_back(localQueues[i].get());
+                stealing = true;
+            }
+            isExpired = !stealing && Clock::now() > item.deadline;
+            if(isExpired) ++expired[item.lane];
+        }
+        if(stealing){
+            if(stealLocal(victims, fast)) fast();
+            continue;
+        }
+        if(isExpired){
+            if(item.onExpire) item.onExpire();
+            continue;   //item.task随item销毁，future得到broken_promise
+        }
+        item.task();
+    }
+}
+
 ThreadPool::~ThreadPool(){
+    timers.reset();     //先停掉时间轮，已经到期投递进来的任务照常执行完
     {
         std::unique_lock<std::mutex> lock(tasks_mtx);
         stop = true;
     }
     cv.notify_all();
-    for(std::thread &th : threads){
+    {
+        std::unique_lock<std::mutex> lock(spaceMtx);    //让阻塞在有界队列上的提交方看到stop
+    }
+    spaceCv.notify_all();
+    for(std::thread &th : threads){     //包括已退出的弹性线程，未使用的槽位不可join
         if(th.joinable())
             th.join();
     }
 }
 
+TimerWheel &ThreadPool::timerWheel(){
+    if(stop)
+        throw std::runtime_error("schedule on stopped ThreadPool");
+    std::call_once(timersOnce, [this](){
+        //到期的任务只做非阻塞入队：时间轮线程不在满队列上阻塞，也不替线程池执行任务（会拖住其他定时器）。
+        //有界队列已满或线程池已停止时丢弃该次任务并计数
+        timers.reset(new TimerWheel([this](Task task){
+            bool queued = false;
+            try {
+                queued = tryPushNormal(task);
+            } catch(const std::runtime_error &) {     //只可能来自线程池已停止，任务没有执行过
+            }
+            if(!queued)
+                ++timerDropped;
+        }));
+    });
+    return *timers;
+}
+
+TimerId ThreadPool::scheduleEvery(Clock::duration period, Task task){
+    return timerWheel().addEvery(period, std::move(task));
+}
+
+bool ThreadPool::cancelTimer(TimerId id){
+    return timers ? timers->cancel(id) : false;
+}
+
+void ThreadPool::push(TaskPriority pri, Task task, Clock::time_point deadline, std::function<void()> onExpire){
+    bool wake;
+    {
+        std::unique_lock<std::mutex> lock(tasks_mtx);
+
+        // don't allow enqueueing after stopping the pool
+        if(stop)
+            throw std::runtime_error("enqueue on stopped ThreadPool");
+
+        Item item;
+        item.task = std::move(task);
+        item.enqueueTime = Clock::now();
+        item.deadline = deadline;
+        item.onExpire = std::move(onExpire);
+        item.lane = static_cast<int>(pri);
+        lanes[static_cast<int>(pri)].push_back(std::move(item));
+        ++pending;
+        if(pri == TaskPriority::HIGH) ++highPending;
+
+        //没有休眠的线程时不必notify：忙碌或自旋中的线程自己会看到新任务
+        wake = idle > 0;
+        if(!wake && static_cast<int>(pending) >= growThreshold) grow();
+    }
+    if(wake) cv.notify_one();
+}
+
+//调用时须持有tasks_mtx。在空闲槽位上启动一个弹性线程
+void ThreadPool::grow(){
+    for(int i = coreSize; i < maxSize; ++i){
+        if(slotActive[i]) continue;
+        //退休的线程在持锁时让出槽位，之后不再访问共享状态，可以直接join
+        if(threads[i].joinable()) threads[i].join();
+        slotActive[i] = true;
+        ++live;
+        threads[i] = std::thread([this, i](){ worker(i, -1); });
+        return;
+    }
+}
+
+//add提交的任务：有界队列模式进入无锁队列；否则工作线程内部的提交进入本地缓冲，外部的进入NORMAL队列
+void ThreadPool::pushNormal(Task task){
+    if(!ring){
+        if(current == this){
+            pushLocal(std::move(task));
+            return;
+        }
+        push(TaskPriority::NORMAL, std::move(task), Clock::time_point::max(), nullptr);
+        return;
+    }
+    if(stop)
+        throw std::runtime_error("enqueue on stopped ThreadPool");
+    if(ring->tryPush(task)){
+        afterRingPush();
+        return;
+    }
+
+    Backpressure policy = backpressure;
+    if(policy == Backpressure::BLOCK && current == this)
+        policy = Backpressure::CALLER_RUNS;     //工作线程阻塞等自己腾空间可能死锁
+    if(policy == Backpressure::REJECT)
+        throw std::runtime_error("ThreadPool queue is full");
+    if(policy == Backpressure::CALLER_RUNS){
+        task();
+        return;
+    }
+
+    //BLOCK：先短暂自旋，仍满再等spaceCv。先登记blockedProducers再检查空位，
+    //与popRing中“先出队再读blockedProducers”配对，不会丢失唤醒
+    while(true){
+        for(int i = 0; i < 64; ++i){
+            if(ring->tryPush(task)){
+                afterRingPush();
+                return;
+            }
+            cpuRelax();
+        }
+        std::unique_lock<std::mutex> lock(spaceMtx);
+        ++blockedProducers;
+        spaceCv.wait(lock, [this](){
+            return stop || ring->sizeApprox() < ring->capacity();
+        });
+        --blockedProducers;
+        if(stop)
+            throw std::runtime_error("enqueue on stopped ThreadPool");
+    }
+}
+
+bool ThreadPool::tryPushNormal(Task &task){
+    if(!ring){
+        pushNormal(std::move(task));
+        return true;
+    }
+    if(stop)
+        throw std::runtime_error("enqueue on stopped ThreadPool");
+    if(!ring->tryPush(task)) return false;
+    afterRingPush();
+    return true;
+}
+
+//先计数再读idle，与worker中“持锁++idle再检查localPending”配对
+void ThreadPool::pushLocal(Task task){
+    {
+        std::unique_lock<std::mutex> lock(currentLocal->mtx);
+        reserveLocal(1);
+        currentLocal->tasks.push_back(std::move(task));
+    }
+    wakeIdle(1);
+}
+
+//调用时须持有本地缓冲的锁。任务放进去之前先计数：取走任务的一方（持同一把锁）减计数时计数一定已经加过，不会减成回绕的大数；
+//计数之后再检查stop，与worker退出前“先看stop再看localPending”相反，两边总有一方看到对方，任务不会被丢下
+void ThreadPool::reserveLocal(size_t n){
+    localPending += n;
+    if(stop){
+        localPending -= n;
+        throw std::runtime_error("enqueue on stopped ThreadPool");
+    }
+}
+
+//从自己的本地缓冲尾部取（刚提交的任务数据还在缓存里）
+bool ThreadPool::popLocal(Task &task){
+    if(localPending == 0) return false;
+    std::unique_lock<std::mutex> lock(currentLocal->mtx);
+    if(currentLocal->tasks.empty()) return false;
+    task = std::move(currentLocal->tasks.back());
+    currentLocal->tasks.pop_back();
+    --localPending;
+    return true;
+}
+
+//不持有tasks_mtx时调用。从其他线程的本地缓冲头部窃取（最早提交的任务）：
+//先try_lock，对方正忙就换下一个，不在别人的锁上排队；都没拿到再阻塞地检查一遍，免得漏掉被短暂占用的缓冲
+bool ThreadPool::stealLocal(const std::vector<LocalQueue*> &victims, Task &task){
+    for(size_t i = 0; i < victims.size(); ++i){
+        std::unique_lock<std::mutex> lock(victims[i]->mtx, std::try_to_lock);
+        if(!lock.owns_lock() || victims[i]->tasks.empty()) continue;
+        task = std::move(victims[i]->tasks.front());
+        victims[i]->tasks.pop_front();
+        --localPending;
+        return true;
+    }
+    for(size_t i = 0; i < victims.size(); ++i){
+        std::unique_lock<std::mutex> lock(victims[i]->mtx);
+        if(victims[i]->tasks.empty()) continue;
+        task = std::move(victims[i]->tasks.front());
+        victims[i]->tasks.pop_front();
+        --localPending;
+        return true;
+    }
+    return false;
+}
+
+//整批加一次锁；有界队列模式下逐个无锁入队，最后只唤醒一次
+void ThreadPool::pushBulk(std::vector<Task> &tasks){
+    if(tasks.empty()) return;
+    if(stop)
+        throw std::runtime_error("enqueue on stopped ThreadPool");
+    size_t n = tasks.size();
+
+    if(ring){
+        size_t pushed = 0;
+        for(size_t i = 0; i < n; ++i){
+            if(ring->tryPush(tasks[i])){
+                ++pushed;
+                continue;
+            }
+            //队列满：先让已入队的任务可见，剩下的按背压策略逐个处理
+            ringPending += pushed;
+            pushed = 0;
+            wakeIdle(n);
+            pushNormal(std::move(tasks[i]));
+        }
+        ringPending += pushed;
+        wakeIdle(n);
+        return;
+    }
+
+    if(current == this){
+        {
+            std::unique_lock<std::mutex> lock(currentLocal->mtx);
+            reserveLocal(n);
+            for(size_t i = 0; i < n; ++i)
+                currentLocal->tasks.push_back(std::move(tasks[i]));
+        }
+        wakeIdle(n);
+        return;
+    }
+
+    bool wake;
+    {
+        std::unique_lock<std::mutex> lock(tasks_mtx);
+        if(stop)
+            throw std::runtime_error("enqueue on stopped ThreadPool");
+        Clock::time_point now = Clock::now();
+        std::deque<Item> &lane = lanes[static_cast<int>(TaskPriority::NORMAL)];
+        for(size_t i = 0; i < n; ++i){
+            Item item;
+            item.task = std::move(tasks[i]);
+            item.enqueueTime = now;
+            item.deadline = Clock::time_point::max();
+            item.lane = static_cast<int>(TaskPriority::NORMAL);
+            lane.push_back(std::move(item));
+        }
+        pending += n;
+        wake = idle > 0;
+        if(!wake && static_cast<int>(pending) >= growThreshold) grow();
+    }
+    if(wake){
+        if(n == 1) cv.notify_one();
+        else cv.notify_all();
+    }
+}
+
+//不加锁入队之后：有休眠的线程才唤醒，一个任务唤醒一个，一批任务全部唤醒
+void ThreadPool::wakeIdle(size_t n){
+    if(idle == 0) return;
+    { std::unique_lock<std::mutex> lock(tasks_mtx); }
+    if(n == 1) cv.notify_one();
+    else cv.notify_all();
+}
+
+//先计数再读idle，与worker中“持锁++idle再检查ringPending”配对
+void ThreadPool::afterRingPush(){
+    ++ringPending;
+    if(idle > 0){
+        { std::unique_lock<std::mutex> lock(tasks_mtx); }
+        cv.notify_one();
+    }
+}
+
+bool ThreadPool::popRing(Task &task){
+    if(!ring->tryPop(task)) return false;
+    --ringPending;
+    if(blockedProducers > 0){
+        { std::unique_lock<std::mutex> lock(spaceMtx); }
+        spaceCv.notify_one();
+    }
+    return true;
+}
+
+void ThreadPool::pushOnNode(int nodeId, Task task){
+    int node = topology.indexOfNode(nodeId);    //内核编号换算成nodeQueues的下标
+    if(node < 0 || node >= static_cast<int>(nodeQueues.size())
+        || std::find(threadNode.begin(), threadNode.end(), node) == threadNode.end()){
+        push(TaskPriority::NORMAL, std::move(task), Clock::time_point::max(), nullptr);
+        return;
+    }
+    bool wake;
+    {
+        std::unique_lock<std::mutex> lock(tasks_mtx);
+        if(stop)
+            throw std::runtime_error("enqueue on stopped ThreadPool");
+
+        Item item;
+        item.task = std::move(task);
+        item.enqueueTime = Clock::now();
+        item.deadline = Clock::time_point::max();
+        item.lane = static_cast<int>(TaskPriority::NORMAL);
+        nodeQueues[node].push_back(std::move(item));
+        ++nodePending;
+        wake = idle > 0;
+    }
+    if(wake) cv.notify_all();    //所有线程共用一个条件变量，notify_one可能唤醒别的节点的线程
+}
+
+int ThreadPool::nodeCount(){
+    return static_cast<int>(nodeQueues.size());
+}
+
+std::vector<int> ThreadPool::nodeIds(){
+    return nodeQueues.empty() ? std::vector<int>() : topology.nodeIds;
+}
+
+//调用时须持有tasks_mtx。优先取高优先级队列，但非空队列被连续跳过starvationLimit次后必定轮到它
+bool ThreadPool::popNext(Item &item){
+    int chosen = -1;
+    for(int l = 0; l < LANES && chosen == -1; ++l){
+        if(!lanes[l].empty() && laneSkips[l] >= starvationLimit) chosen = l;
+    }
+    for(int l = 0; l < LANES && chosen == -1; ++l){
+        if(!lanes[l].empty()) chosen = l;
+    }
+    if(chosen == -1) return false;
+
+    for(int l = 0; l < LANES; ++l){
+        if(l == chosen) laneSkips[l] = 0;
+        else if(!lanes[l].empty()) ++laneSkips[l];
+    }
+
+    item = std::move(lanes[chosen].front());
+    lanes[chosen].pop_front();
+    if(chosen == static_cast<int>(TaskPriority::HIGH)) --highPending;
+    --pending;
+
+    long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - item.enqueueTime).count();
+    int bucket = 0;
+    while(bucket < BUCKETS - 1 && (1LL << (bucket + 1)) <= ns) ++bucket;
+    ++waitHist[chosen][bucket];
+    return true;
+}
+
+void ThreadPool::setStarvationLimit(int limit){
+    std::unique_lock<std::mutex> lock(tasks_mtx);
+    starvationLimit = limit;
+}
+
+double ThreadPool::queueTimePercentile(TaskPriority pri, double p){
+    std::unique_lock<std::mutex> lock(tasks_mtx);
+    const unsigned long long *hist = waitHist[static_cast<int>(pri)];
+    unsigned long long total = 0;
+    for(int b = 0; b < BUCKETS; ++b) total += hist[b];
+    if(total == 0) return 0.0;
+
+    unsigned long long rank = static_cast<unsigned long long>(p / 100.0 * total + 0.5);
+    if(rank < 1) rank = 1;
+    unsigned long long seen = 0;
+    for(int b = 0; b < BUCKETS; ++b){
+        seen += hist[b];
+        if(seen >= rank) return static_cast<double>(1ULL << (b + 1)) / 1000.0;   //桶上界，纳秒转微秒
+    }
+    return 0.0;
+}
+
+unsigned long long ThreadPool::timerDroppedCount(){
+    return timerDropped;
+}
+
+unsigned long long ThreadPool::expiredCount(TaskPriority pri){
+    std::unique_lock<std::mutex> lock(tasks_mtx);
+    return expired[static_cast<int>(pri)];
+}
+
+void ThreadPool::setIdlePolicy(int spin, int yield){
+    spinCount = spin;
+    yieldCount = yield;
+}
+
+void ThreadPool::setElastic(int maxThreads, int threshold, int idleTimeoutMs){
+    std::unique_lock<std::mutex> lock(tasks_mtx);
+    if(maxThreads > static_cast<int>(threads.size())){
+        threads.resize(maxThreads);
+        slotActive.resize(maxThreads, false);
+        while(static_cast<int>(localQueues.size()) < maxThreads)
+            localQueues.push_back(std::unique_ptr<LocalQueue>(new LocalQueue()));
+    }
+    maxSize = maxThreads;
+    growThreshold = threshold;
+    idleTimeout = std::chrono::milliseconds(idleTimeoutMs);
+}
+
+int ThreadPool::threadCount(){
+    return live;
+}
+
+} // namespace netpool
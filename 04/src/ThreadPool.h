@@ -7,51 +7,297 @@
 #pragma once
 #include <functional>
 #include <vector>
-#include <queue>
+#include <deque>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <future>
+#include <chrono>
+#include <stdexcept>
+#include <atomic>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include "Topology.h"
+#include "MpmcQueue.h"
+#include "TimerWheel.h"
+#include "Task.h"
+
+namespace netpool {
+
+// 任务优先级，每个优先级一条队列：网络请求等延迟敏感的任务用HIGH，帧缩放等后台任务用LOW
+enum class TaskPriority { HIGH = 0, NORMAL = 1, LOW = 2 };
+
+// 工作线程的CPU放置：NONE不绑定；PIN_CPUS第i个线程绑定到cpuSet的第i个CPU（cpuSet为空时用在线CPU）；
+// SPREAD_NODES线程轮流分到各NUMA节点，绑定到该节点的全部CPU
+enum class Placement { NONE, PIN_CPUS, SPREAD_NODES };
+
+// 有界队列满时add的处理方式：BLOCK阻塞等空位（工作线程内的提交改为就地执行，避免互相等待），
+// REJECT抛出std::runtime_error，CALLER_RUNS在提交方线程直接执行
+enum class Backpressure { BLOCK, REJECT, CALLER_RUNS };
+
+// 任务保存的是F和Args退化后的副本，执行时以右值调用（见bindArgs），结果类型按这个形式推导；
+// 不能这样调用时替换失败，错误出现在提交处，而不是线程池内部
+template<class F, class... Args>
+using TaskResult = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
+
+// 同样的检查，用于不返回future的提交接口：满足时类型为R
+template<class R, class F, class... Args>
+using IfTask = std::enable_if_t<std::is_invocable<std::decay_t<F>, std::decay_t<Args>...>::value, R>;
 
 class ThreadPool
 {
+public:
+    typedef std::chrono::steady_clock Clock;
+
 private:
+    static const int LANES = 3;
+    static const int BUCKETS = 48;
+    static const int RING_BATCH = 16;       // 连续从有界队列取这么多个任务后，去加锁的队列看一次
+    static const int LOCAL_BATCH = 16;      // 连续从本地缓冲取这么多个任务后，去加锁的队列看一次
+
+    struct Item {
+        Task task;
+        Clock::time_point enqueueTime;
+        Clock::time_point deadline;         // 出队时已超过截止时间的任务不执行
+        std::function<void()> onExpire;     // 过期时代替任务执行的回调，可以为空
+        int lane;
+    };
+
     std::vector<std::thread> threads;
-    std::queue<std::function<void()>> tasks;
+    std::deque<Item> lanes[LANES];
+    int laneSkips[LANES];                   // 非空却被跳过的连续次数，用于防止低优先级饿死
+    int starvationLimit;
+    unsigned long long waitHist[LANES][BUCKETS];   // 排队时间直方图，按纳秒数的2的幂分桶
+    unsigned long long expired[LANES];
+    std::atomic<size_t> pending;            // 优先级队列中的任务数，空闲线程自旋时不加锁读取
+    CpuTopology topology;
+    std::vector<int> threadNode;                // 每个线程所在节点在topology.nodes中的下标
+    std::vector<std::deque<Item> > nodeQueues;  // 定向到某个节点的任务，只由该节点的线程执行
+    std::atomic<size_t> nodePending;            // 所有节点队列中的任务数
+    std::atomic<int> spinCount;                 // 休眠前的自旋次数
+    std::atomic<int> yieldCount;                // 自旋之后yield的次数
+    std::atomic<int> idle;                      // 正在cv上休眠的线程数，持锁修改
+    int coreSize;                               // 常驻线程数
+    int maxSize;                                // 弹性上限，不大于coreSize时线程数固定
+    int growThreshold;
+    std::chrono::milliseconds idleTimeout;
+    std::atomic<int> live;                      // 运行中的线程数
+    std::vector<bool> slotActive;               // 槽位上是否有运行中的线程
     std::mutex tasks_mtx;
     std::condition_variable cv;
-    bool stop;
+    std::atomic<bool> stop;
+
+    // 工作线程内部add的任务进入自己的本地缓冲（各有一把锁，基本没有争用），不碰tasks_mtx；
+    // 其他线程在加锁的队列都空了时从这里窃取
+    struct LocalQueue {
+        std::mutex mtx;
+        std::deque<Task> tasks;
+    };
+    std::vector<std::unique_ptr<LocalQueue> > localQueues;     // 每个槽位一个，由tasks_mtx保护
+    std::atomic<size_t> localPending;                           // 所有本地缓冲中的任务数
+    static thread_local LocalQueue *currentLocal;               // 当前工作线程的本地缓冲
+
+    // 有界无锁队列：容量非0时add提交的任务进入这里，不经过tasks_mtx
+    std::unique_ptr<MpmcQueue<Task> > ring;
+    Backpressure backpressure;
+    std::atomic<size_t> ringPending;
+    std::atomic<int> highPending;               // HIGH队列中的任务数，非0时先服务它
+    std::atomic<int> blockedProducers;
+    std::mutex spaceMtx;
+    std::condition_variable spaceCv;            // 有界队列腾出空位时通知阻塞的提交方
+    static thread_local ThreadPool *current;    // 当前线程所属的线程池，用于识别工作线程内的提交
+    std::once_flag timersOnce;
+    std::unique_ptr<TimerWheel> timers;         // 定时任务的时间轮，第一次调度定时任务时才创建
+    std::atomic<unsigned long long> timerDropped;   // 到期后没能入队的定时任务数
+
+    void push(TaskPriority pri, Task task, Clock::time_point deadline, std::function<void()> onExpire);
+    bool popNext(Item &item);
+    void pushOnNode(int nodeId, Task task);
+    void worker(int id, int node);
+    void grow();
+    void pushNormal(Task task);
+    bool tryPushNormal(Task &task);
+    void afterRingPush();
+    bool popRing(Task &task);
+    void pushLocal(Task task);
+    bool popLocal(Task &task);
+    bool stealLocal(const std::vector<LocalQueue*> &victims, Task &task);
+    void reserveLocal(size_t n);
+    void pushBulk(std::vector<Task> &tasks);
+    void wakeIdle(size_t n);
+    TimerWheel &timerWheel();
+
+    // 把可调用对象和参数按值打包成一个无参可调用对象，调用时参数以右值传入（与std::thread一致），
+    // 可以携带unique_ptr这类只可移动的参数
+    template<class F, class... Args>
+    static auto bindArgs(F&& f, Args&&... args) {
+        return [fn = std::forward<F>(f), params = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+            return std::apply(std::move(fn), std::move(params));
+        };
+    }
 public:
-    ThreadPool(int size = 10);
+    // queueCapacity为0时队列不设上限；非0时add走容量为queueCapacity的有界无锁队列，满时按policy处理。
+    // cpuSet只对PIN_CPUS有效，第i个线程绑定到cpuSet[i % cpuSet.size()]
+    ThreadPool(int size = 10, Placement placement = Placement::NONE,
+               size_t queueCapacity = 0, Backpressure policy = Backpressure::BLOCK,
+               const std::vector<int> &cpuSet = std::vector<int>());
     ~ThreadPool();
 
-    // void add(std::function<void()>);
     template<class F, class... Args>
-    auto add(F&& f, Args&&... args) 
-    -> std::future<typename std::result_of<F(Args...)>::type>;
+    auto add(F&& f, Args&&... args)
+    -> std::future<TaskResult<F, Args...>>;
+
+    // 不关心结果的提交：不创建packaged_task和future，可调用对象直接移动进队列。
+    // 任务抛出的异常不会被捕获（与std::thread一致，会导致std::terminate）
+    template<class F, class... Args>
+    auto submitDetached(F&& f, Args&&... args) -> IfTask<void, F, Args...>;
+
+    // 批量提交[first, last)中的可调用对象：整批只加一次锁、只唤醒一次，future按顺序返回。
+    // 有界队列模式下逐个无锁入队，满了按背压策略处理
+    template<class InputIt>
+    auto addBulk(InputIt first, InputIt last)
+    -> std::vector<std::future<std::invoke_result_t<typename std::iterator_traits<InputIt>::reference>> >;
+
+    // 非阻塞提交：有界队列已满时返回false（可调用对象随之销毁），成功时通过res返回future
+    template<class F, class... Args>
+    bool tryAdd(std::future<TaskResult<F, Args...>> &res, F&& f, Args&&... args);
+
+    template<class F, class... Args>
+    auto addWithPriority(TaskPriority pri, F&& f, Args&&... args)
+    -> std::future<TaskResult<F, Args...>>;
+
+    // 过期的任务不会执行，返回的future得到broken_promise
+    template<class F, class... Args>
+    auto addWithDeadline(TaskPriority pri, Clock::time_point deadline, std::function<void()> onExpire, F&& f, Args&&... args)
+    -> std::future<TaskResult<F, Args...>>;
+
+    // 提交到指定NUMA节点的线程执行，让节点N上分配的数据由节点N的CPU处理。
+    // node是内核的节点编号（与/sys/devices/system/node/nodeN一致），可用的编号见nodeIds()；
+    // placement为NONE、节点不存在或该节点没有线程时等同于add
+    template<class F, class... Args>
+    auto addOnNode(int node, F&& f, Args&&... args)
+    -> std::future<TaskResult<F, Args...>>;
+
+    int nodeCount();
+    std::vector<int> nodeIds();     // 有CPU的节点的内核编号，placement为NONE时为空
+
+    // 延迟任务：delay之后按add的方式投递（精度1ms，不会提前），返回的句柄用于cancelTimer。
+    // 计时由一个独立的时间轮线程负责，不占用工作线程；线程池析构时未到期的定时器被丢弃
+    template<class F, class... Args>
+    auto scheduleAfter(Clock::duration delay, F&& f, Args&&... args) -> IfTask<TimerId, F, Args...>;
+
+    template<class F, class... Args>
+    auto scheduleAt(Clock::time_point when, F&& f, Args&&... args) -> IfTask<TimerId, F, Args...>;
 
+    // 周期任务：首次在period之后执行，此后每隔period执行一次，上一次还在执行时跳过本次
+    TimerId scheduleEvery(Clock::duration period, Task task);
+    bool cancelTimer(TimerId id);   //已触发或已取消时返回false
+    // 到期时因有界队列已满或线程池已停止而丢弃的定时任务数：到期的任务只做非阻塞入队，不走背压策略
+    unsigned long long timerDroppedCount();
+
+    // 空闲策略：找不到任务时先自旋spin次、再yield若干次，最后才休眠。
+    // 突发的小任务间隔很短时可以省掉futex唤醒；默认0，直接休眠
+    void setIdlePolicy(int spin, int yield);
+
+    // 弹性伸缩：没有空闲线程且排队任务数达到growThreshold时加线程，最多到maxThreads；
+    // 新增的线程空闲idleTimeoutMs毫秒后退出。构造时创建的线程始终保留
+    void setElastic(int maxThreads, int growThreshold, int idleTimeoutMs);
+    int threadCount();
+
+    // 被服务前，非空的低优先级队列最多连续被跳过limit次
+    void setStarvationLimit(int limit);
+
+    // 某个优先级的排队时间分位数（p取0~100），单位微秒；精度在2倍以内
+    double queueTimePercentile(TaskPriority pri, double p);
+    unsigned long long expiredCount(TaskPriority pri);
 };
 
 
 //不能放在cpp文件，原因是C++编译器不支持模版的分离编译
+//packaged_task只可移动，直接放进Task里，不再经过make_shared和std::bind
 template<class F, class... Args>
-auto ThreadPool::add(F&& f, Args&&... args) -> std::future<typename std::result_of<F(Args...)>::type> {
-    using return_type = typename std::result_of<F(Args...)>::type;
+auto ThreadPool::add(F&& f, Args&&... args) -> std::future<TaskResult<F, Args...>> {
+    using return_type = TaskResult<F, Args...>;
 
-    auto task = std::make_shared< std::packaged_task<return_type()> >(
-            std::bind(std::forward<F>(f), std::forward<Args>(args)...)
-        );
-        
-    std::future<return_type> res = task->get_future();
-    {
-        std::unique_lock<std::mutex> lock(tasks_mtx);
+    std::packaged_task<return_type()> task(bindArgs(std::forward<F>(f), std::forward<Args>(args)...));
+    std::future<return_type> res = task.get_future();
+    pushNormal(std::move(task));
+    return res;
+}
+
+template<class F, class... Args>
+auto ThreadPool::submitDetached(F&& f, Args&&... args) -> IfTask<void, F, Args...> {
+    if constexpr (sizeof...(Args) == 0)
+        pushNormal(std::forward<F>(f));
+    else
+        pushNormal(bindArgs(std::forward<F>(f), std::forward<Args>(args)...));
+}
 
-        // don't allow enqueueing after stopping the pool
-        if(stop)
-            throw std::runtime_error("enqueue on stopped ThreadPool");
+template<class F, class... Args>
+bool ThreadPool::tryAdd(std::future<TaskResult<F, Args...>> &res, F&& f, Args&&... args) {
+    using return_type = TaskResult<F, Args...>;
+
+    std::packaged_task<return_type()> task(bindArgs(std::forward<F>(f), std::forward<Args>(args)...));
+    std::future<return_type> fut = task.get_future();
+    Task fn(std::move(task));
+    if(!tryPushNormal(fn)) return false;
+    res = std::move(fut);
+    return true;
+}
+
+template<class F, class... Args>
+auto ThreadPool::addWithPriority(TaskPriority pri, F&& f, Args&&... args) -> std::future<TaskResult<F, Args...>> {
+    return addWithDeadline(pri, Clock::time_point::max(), nullptr,
+                           std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+template<class F, class... Args>
+auto ThreadPool::addWithDeadline(TaskPriority pri, Clock::time_point deadline, std::function<void()> onExpire, F&& f, Args&&... args)
+-> std::future<TaskResult<F, Args...>> {
+    using return_type = TaskResult<F, Args...>;
 
-        tasks.emplace([task](){ (*task)(); });
+    std::packaged_task<return_type()> task(bindArgs(std::forward<F>(f), std::forward<Args>(args)...));
+    std::future<return_type> res = task.get_future();
+    push(pri, std::move(task), deadline, std::move(onExpire));
+    return res;
+}
+
+template<class F, class... Args>
+auto ThreadPool::addOnNode(int node, F&& f, Args&&... args)
+-> std::future<TaskResult<F, Args...>> {
+    using return_type = TaskResult<F, Args...>;
+
+    std::packaged_task<return_type()> task(bindArgs(std::forward<F>(f), std::forward<Args>(args)...));
+    std::future<return_type> res = task.get_future();
+    pushOnNode(node, std::move(task));
+    return res;
+}
+
+template<class F, class... Args>
+auto ThreadPool::scheduleAfter(Clock::duration delay, F&& f, Args&&... args) -> IfTask<TimerId, F, Args...> {
+    return scheduleAt(Clock::now() + delay, std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+template<class F, class... Args>
+auto ThreadPool::scheduleAt(Clock::time_point when, F&& f, Args&&... args) -> IfTask<TimerId, F, Args...> {
+    return timerWheel().addAt(when, bindArgs(std::forward<F>(f), std::forward<Args>(args)...));
+}
+
+template<class InputIt>
+auto ThreadPool::addBulk(InputIt first, InputIt last)
+-> std::vector<std::future<std::invoke_result_t<typename std::iterator_traits<InputIt>::reference>>> {
+    using return_type = std::invoke_result_t<typename std::iterator_traits<InputIt>::reference>;
+
+    std::vector<std::future<return_type> > res;
+    std::vector<Task> tasks;
+    for(; first != last; ++first){
+        std::packaged_task<return_type()> task(*first);
+        res.push_back(task.get_future());
+        tasks.push_back(std::move(task));
     }
-    cv.notify_one();
+    pushBulk(tasks);
     return res;
 }
+
+} // namespace netpool
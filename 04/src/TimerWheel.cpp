@@ -0,0 +1,259 @@
+/******************************
+*   author: yuesong-feng
+*   
+*
+*
+******************************/
+#include "TimerWheel.h"
+
+namespace netpool {
+
+const uint32_t TimerWheel::NPOS;     //vector构造按引用传参，需要类外定义
+
+TimerWheel::TimerWheel(Dispatch _dispatch, Clock::duration _tick)
+    : dispatch(std::move(_dispatch)), tick(_tick), start(Clock::now()),
+      heads(LEVELS * SLOTS, NPOS), freeHead(NPOS), nextTick(0), wakeTick(0), active(0), stop(false){
+    thread = std::thread(&TimerWheel::run, this);
+}
+
+TimerWheel::~TimerWheel(){
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        stop = true;
+    }
+    cv.notify_one();
+    thread.join();
+}
+
+TimerId TimerWheel::addAt(Clock::time_point when, Task task){
+    std::unique_lock<std::mutex> lock(mtx);
+    catchUpIdle();
+    uint32_t n = allocate();
+    nodes[n].task = std::move(task);
+    link(n, ticksUntil(when));
+    return inserted(n);
+}
+
+TimerId TimerWheel::addEvery(Clock::duration period, Task task){
+    std::unique_lock<std::mutex> lock(mtx);
+    catchUpIdle();
+    uint32_t n = allocate();
+    nodes[n].period = period <= tick ? 1 : static_cast<uint64_t>(period / tick);
+    nodes[n].periodic = std::make_shared<Periodic>(std::move(task));
+    link(n, ticksUntil(Clock::now() + period));
+    return inserted(n);
+}
+
+bool TimerWheel::cancel(TimerId id){
+    uint32_t n = static_cast<uint32_t>(id & 0xffffffffu);
+    uint32_t gen = static_cast<uint32_t>(id >> 32);
+    std::unique_lock<std::mutex> lock(mtx);
+    if(n >= nodes.size() || nodes[n].generation != gen || !nodes[n].linked)
+        return false;
+    unlink(n);
+    release(n);
+    return true;
+}
+
+size_t TimerWheel::pending(){
+    std::unique_lock<std::mutex> lock(mtx);
+    return active;
+}
+
+uint32_t TimerWheel::allocate(){
+    if(freeHead != NPOS){
+        uint32_t n = freeHead;
+        freeHead = nodes[n].next;
+        return n;
+    }
+    nodes.push_back(Node());
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+//节点回收到空闲链表，代数加一使旧句柄失效
+void TimerWheel::release(uint32_t n){
+    Node &node = nodes[n];
+    node.task = Task();
+    node.periodic.reset();
+    node.period = 0;
+    if(++node.generation == 0)
+        node.generation = 1;    //保证句柄不为0
+    node.next = freeHead;
+    freeHead = n;
+}
+
+TimerId TimerWheel::inserted(uint32_t n){
+    //没有定时器时时间轮线程无限期休眠，有定时器时睡到最近的事件；新定时器更早时叫醒它重新计算
+    if(active++ == 0 || nodes[n].expire < wakeTick)
+        cv.notify_one();
+    return (static_cast<TimerId>(nodes[n].generation) << 32) | n;
+}
+
+TimerWheel::Clock::time_point TimerWheel::timeOf(uint64_t t){
+    return start + tick * static_cast<int64_t>(t);
+}
+
+//向上取整，保证不早于给定时刻
+uint64_t TimerWheel::ticksUntil(Clock::time_point when){
+    if(when <= start)
+        return 0;
+    return static_cast<uint64_t>((when - start + tick - Clock::duration(1)) / tick);
+}
+
+//到now为止已经到期的最后一个tick
+uint64_t TimerWheel::lastDueTick(Clock::time_point now){
+    if(now < start)
+        return 0;
+    return static_cast<uint64_t>((now - start) / tick);
+}
+
+//从nextTick开始第一个需要处理的tick：第0层最近的非空槽，或者最近一次要级联出非空槽的整256个tick。
+//中间的tick推进时什么也不做，可以直接跳过，时间轮线程也不必每个tick醒一次
+uint64_t TimerWheel::nextEventTick(){
+    uint64_t nearest = UINT64_MAX;
+    for(uint64_t t = nextTick; t < nextTick + SLOTS; ++t){     //第0层只放一圈之内到期的
+        if(heads[t & (SLOTS - 1)] != NPOS){
+            nearest = t;
+            break;
+        }
+    }
+    //上层的槽只在级联时处理，只需检查整256的tick；扫描的边界数有上限，超过时先醒一次再算
+    uint64_t boundary = (nextTick + SLOTS - 1) & ~uint64_t(SLOTS - 1);
+    for(int i = 0; i < SLOTS && boundary < nearest; ++i, boundary += SLOTS){
+        for(int level = 1; level < LEVELS; ++level){
+            if((boundary & ((uint64_t(1) << (SLOT_BITS * level)) - 1)) != 0)
+                break;
+            if(heads[level * SLOTS + ((boundary >> (SLOT_BITS * level)) & (SLOTS - 1))] != NPOS)
+                return boundary;
+        }
+    }
+    return nearest < boundary ? nearest : boundary;
+}
+
+//没有定时器时不推进tick，插入前直接拨到现在，免得之后逐个tick地追赶
+void TimerWheel::catchUpIdle(){
+    if(active != 0)
+        return;
+    uint64_t elapsed = static_cast<uint64_t>((Clock::now() - start) / tick);
+    if(elapsed > nextTick)
+        nextTick = elapsed;
+}
+
+//第0层放[nextTick, nextTick+256)内到期的，第k层每个槽覆盖256^k个tick
+void TimerWheel::link(uint32_t n, uint64_t expire){
+    Node &node = nodes[n];
+    if(expire < nextTick)
+        expire = nextTick;      //已经过期的放到下一个tick
+    node.expire = expire;
+
+    uint64_t delta = expire - nextTick;
+    int level = 0;
+    while(level + 1 < LEVELS && delta >= (uint64_t(1) << (SLOT_BITS * (level + 1))))
+        ++level;
+    uint64_t at = expire;
+    if(level == LEVELS - 1 && delta >= (uint64_t(1) << (SLOT_BITS * LEVELS)))
+        at = nextTick + (uint64_t(1) << (SLOT_BITS * LEVELS)) - 1;    //超出跨度：先放在最远的槽，级联时再重新分配
+    size_t slot = level * SLOTS + ((at >> (SLOT_BITS * level)) & (SLOTS - 1));
+
+    node.slot = static_cast<uint32_t>(slot);
+    node.prev = NPOS;
+    node.next = heads[slot];
+    if(node.next != NPOS)
+        nodes[node.next].prev = n;
+    heads[slot] = n;
+    node.linked = true;
+}
+
+void TimerWheel::unlink(uint32_t n){
+    Node &node = nodes[n];
+    if(node.prev != NPOS)
+        nodes[node.prev].next = node.next;
+    else
+        heads[node.slot] = node.next;
+    if(node.next != NPOS)
+        nodes[node.next].prev = node.prev;
+    node.prev = node.next = NPOS;
+    node.linked = false;
+    --active;
+}
+
+uint32_t TimerWheel::takeSlot(size_t slot){
+    uint32_t n = heads[slot];
+    heads[slot] = NPOS;
+    return n;
+}
+
+//处理nextTick：必要时先把上层的槽级联下来，再收集第0层对应槽里到期的任务
+void TimerWheel::advance(std::vector<Task> &due){
+    const uint64_t now = nextTick;
+    for(int level = 1; level < LEVELS; ++level){
+        if((now & ((uint64_t(1) << (SLOT_BITS * level)) - 1)) != 0)
+            break;
+        size_t slot = level * SLOTS + ((now >> (SLOT_BITS * level)) & (SLOTS - 1));
+        for(uint32_t n = takeSlot(slot); n != NPOS; ){
+            uint32_t next = nodes[n].next;
+            link(n, nodes[n].expire);   //active不变
+            n = next;
+        }
+    }
+
+    for(uint32_t n = takeSlot(now & (SLOTS - 1)); n != NPOS; ){
+        uint32_t next = nodes[n].next;
+        Node &node = nodes[n];
+        if(node.expire > now){
+            link(n, node.expire);       //超出跨度的定时器，重新分配
+        } else if(node.period != 0){
+            std::shared_ptr<Periodic> p = node.periodic;
+            if(!p->running.exchange(true)){
+                due.push_back([guard = RunningGuard(p)]() mutable {
+                    guard.p->fn();
+                });
+            }
+            link(n, node.expire + node.period);     //按计划时间累加，不随处理延迟漂移
+        } else {
+            node.linked = false;
+            --active;
+            due.push_back(std::move(node.task));
+            release(n);
+        }
+        n = next;
+    }
+    nextTick = now + 1;
+}
+
+void TimerWheel::run(){
+    std::vector<Task> due;
+    std::unique_lock<std::mutex> lock(mtx);
+    while(!stop){
+        if(active == 0){
+            cv.wait(lock, [this](){ return stop || active > 0; });
+            continue;
+        }
+        //处理到当前时刻为止经过的所有tick，线程被延迟调度时一次追上；没有事件的tick直接跳过
+        const uint64_t lastDue = lastDueTick(Clock::now());
+        while(active > 0 && nextTick <= lastDue){
+            uint64_t event = nextEventTick();
+            if(event > nextTick){
+                nextTick = event <= lastDue ? event : lastDue + 1;
+                continue;
+            }
+            advance(due);
+        }
+
+        if(!due.empty()){
+            lock.unlock();
+            for(size_t i = 0; i < due.size(); ++i)
+                dispatch(std::move(due[i]));
+            due.clear();
+            lock.lock();
+            continue;
+        }
+        if(active > 0){
+            wakeTick = nextEventTick();
+            cv.wait_until(lock, timeOf(wakeTick));
+            wakeTick = 0;
+        }
+    }
+}
+
+} // namespace netpool
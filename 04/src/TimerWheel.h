@@ -0,0 +1,107 @@
+/******************************
+*   author: yuesong-feng
+*   
+*
+*
+******************************/
+#pragma once
+#include <functional>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <atomic>
+#include <cstdint>
+#include "Task.h"
+
+namespace netpool {
+
+// 定时器句柄：低32位是节点下标，高32位是节点的代数，节点被复用后旧句柄自动失效；0表示无效
+typedef uint64_t TimerId;
+
+// 分层时间轮：4层、每层256个槽，最底层一格一个tick（默认1ms）。
+// 每个槽是一条侵入式双向链表，插入和取消都是O(1)；每256个tick把上一层的一个槽重新分散到下层。
+// 到期的任务不在时间轮线程上执行，而是交给dispatch（线程池里就是投递到任务队列）
+class TimerWheel
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+    typedef std::function<void(Task)> Dispatch;
+
+    explicit TimerWheel(Dispatch dispatch, Clock::duration tick = std::chrono::milliseconds(1));
+    ~TimerWheel();      //停止时间轮线程，未到期的定时器直接丢弃
+
+    TimerId addAt(Clock::time_point when, Task task);     //不会早于when执行
+    // 首次在period之后执行，此后每隔period执行一次；上一次还没执行完时跳过这一次
+    TimerId addEvery(Clock::duration period, Task task);
+    bool cancel(TimerId id);    //定时器不存在或已经触发过时返回false
+    size_t pending();
+
+private:
+    static const uint32_t NPOS = 0xffffffffu;
+    static const int SLOT_BITS = 8;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const int LEVELS = 4;
+
+    struct Periodic {
+        Task fn;
+        std::atomic<bool> running;
+        Periodic(Task f) : fn(std::move(f)), running(false) {}
+    };
+
+    //投递出去的每次执行持有一个：正常返回、抛出异常或被线程池丢弃时都在析构里清除running
+    struct RunningGuard {
+        std::shared_ptr<Periodic> p;
+        explicit RunningGuard(std::shared_ptr<Periodic> periodic) : p(std::move(periodic)) {}
+        RunningGuard(RunningGuard &&) noexcept = default;
+        RunningGuard &operator=(RunningGuard &&) = delete;
+        ~RunningGuard(){
+            if(p)
+                p->running = false;
+        }
+    };
+
+    struct Node {
+        uint32_t prev, next;
+        uint32_t slot;              //所在链表头在heads中的下标
+        uint32_t generation;
+        bool linked;
+        uint64_t expire;            //到期的tick
+        uint64_t period;            //周期（tick），0表示一次性
+        Task task;
+        std::shared_ptr<Periodic> periodic;
+        Node() : prev(NPOS), next(NPOS), slot(0), generation(1), linked(false), expire(0), period(0) {}
+    };
+
+    Dispatch dispatch;
+    const Clock::duration tick;
+    const Clock::time_point start;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::vector<Node> nodes;
+    std::vector<uint32_t> heads;
+    uint32_t freeHead;
+    uint64_t nextTick;          //下一个待处理的tick
+    uint64_t wakeTick;          //时间轮线程休眠到的tick，更早的插入需要叫醒它
+    size_t active;              //链表中的定时器数
+    bool stop;
+    std::thread thread;
+
+    uint32_t allocate();
+    void release(uint32_t n);
+    TimerId inserted(uint32_t n);
+    Clock::time_point timeOf(uint64_t t);
+    uint64_t ticksUntil(Clock::time_point when);
+    uint64_t lastDueTick(Clock::time_point now);
+    uint64_t nextEventTick();
+    void catchUpIdle();
+    void link(uint32_t n, uint64_t expire);
+    void unlink(uint32_t n);
+    uint32_t takeSlot(size_t slot);
+    void advance(std::vector<Task> &due);
+    void run();
+};
+
+} // namespace netpool
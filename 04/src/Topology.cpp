@@ -0,0 +1,110 @@
+/******************************
+*   author: yuesong-feng
+*   
+*
+*
+******************************/
+#include "Topology.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <string>
+
+namespace netpool {
+
+std::vector<int> CpuTopology::parseList(const char *text){
+    std::vector<int> result;
+    const char *p = text;
+    while(*p){
+        char *end;
+        long first = strtol(p, &end, 10);
+        if(end == p) break;
+        long last = first;
+        p = end;
+        if(*p == '-'){
+            last = strtol(p + 1, &end, 10);
+            if(end == p + 1) return std::vector<int>();
+            p = end;
+        }
+        for(long c = first; c <= last; ++c) result.push_back(static_cast<int>(c));
+        if(*p == ',') ++p;
+    }
+    return result;
+}
+
+CpuTopology CpuTopology::detect(const char *root){
+    CpuTopology topo;
+    std::string base(root);
+
+    char line[1024] = {0};
+    FILE *fp = fopen((base + "/online").c_str(), "r");
+    if(fp){
+        if(fgets(line, sizeof(line), fp) == nullptr) line[0] = '\0';
+        fclose(fp);
+    }
+    topo.cpus = parseList(line);
+
+    std::vector<std::pair<int, int> > cpuNode;  //(节点, CPU)
+    for(size_t i = 0; i < topo.cpus.size(); ++i){
+        int node = 0;
+        DIR *dir = opendir((base + "/cpu" + std::to_string(topo.cpus[i])).c_str());
+        if(dir){
+            //cpuN目录下有一个指向所属节点的nodeM链接
+            struct dirent *ent;
+            while((ent = readdir(dir)) != nullptr){
+                if(strncmp(ent->d_name, "node", 4) == 0 && isdigit(static_cast<unsigned char>(ent->d_name[4]))){
+                    node = atoi(ent->d_name + 4);
+                    break;
+                }
+            }
+            closedir(dir);
+        }
+        cpuNode.push_back(std::make_pair(node, topo.cpus[i]));
+    }
+
+    if(topo.cpus.empty()){
+        int n = std::max(1u, std::thread::hardware_concurrency());
+        for(int i = 0; i < n; ++i){
+            topo.cpus.push_back(i);
+            cpuNode.push_back(std::make_pair(0, i));
+        }
+    }
+
+    std::sort(cpuNode.begin(), cpuNode.end());
+    int current = -1;
+    for(size_t i = 0; i < cpuNode.size(); ++i){
+        if(cpuNode[i].first != current){
+            topo.nodes.push_back(std::vector<int>());
+            topo.nodeIds.push_back(cpuNode[i].first);
+            current = cpuNode[i].first;
+        }
+        topo.nodes.back().push_back(cpuNode[i].second);
+    }
+    return topo;
+}
+
+int CpuTopology::indexOfNode(int id) const{
+    for(size_t k = 0; k < nodeIds.size(); ++k){
+        if(nodeIds[k] == id) return static_cast<int>(k);
+    }
+    return -1;
+}
+
+bool CpuTopology::pinCurrentThread(const std::vector<int> &cpuSet){
+    if(cpuSet.empty()) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(size_t i = 0; i < cpuSet.size(); ++i){
+        if(cpuSet[i] >= 0 && cpuSet[i] < CPU_SETSIZE) CPU_SET(cpuSet[i], &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+} // namespace netpool
@@ -0,0 +1,28 @@
+/******************************
+*   author: yuesong-feng
+*   
+*
+*
+******************************/
+#pragma once
+#include <vector>
+
+namespace netpool {
+
+// 从/sys/devices/system/cpu读取在线CPU及其所属NUMA节点；读不到时退化为一个节点
+class CpuTopology
+{
+public:
+    std::vector<int> cpus;                  // 在线CPU编号，升序
+    std::vector<std::vector<int> > nodes;   // 每个节点上的CPU，跳过没有CPU的节点
+    std::vector<int> nodeIds;               // nodes[k]对应的内核节点编号，跳过无CPU节点后不一定等于k
+
+    int nodeCount() const { return static_cast<int>(nodes.size()); }
+    int indexOfNode(int id) const;          // 内核节点编号在nodes中的下标，没有该节点时返回-1
+
+    static CpuTopology detect(const char *root = "/sys/devices/system/cpu");
+    static std::vector<int> parseList(const char *text);     // 解析"0-3,8"
+    static bool pinCurrentThread(const std::vector<int> &cpuSet);   // 绑定失败只影响性能，不影响正确性
+};
+
+} // namespace netpool
@@ -2,6 +2,7 @@
 #include <unistd.h>
 #include <string.h>
 #include <functional>
+#include <vector>
 #include "src/util.h"
 #include "src/Buffer.h"
 #include "src/InetAddress.h"
@@ -76,11 +77,10 @@ int main(int argc, char *argv[]) {
         }
     }
 
-    ThreadPool *poll = new ThreadPool(threads);
-    std::function<void()> func = std::bind(oneClient, msgs, wait);
-    for(int i = 0; i < threads; ++i){
-        poll->add(func);
-    }
+    netpool::ThreadPool *poll = new netpool::ThreadPool(threads);
+    //所有客户端一次性提交：只加一次锁、只唤醒一次
+    std::vector<std::function<void()> > clients(threads, std::bind(oneClient, msgs, wait));
+    poll->addBulk(clients.begin(), clients.end());
     delete poll;
     return 0;
 }